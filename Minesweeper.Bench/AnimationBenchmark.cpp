@@ -0,0 +1,140 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "MineRings.h"
+#include "MineTimeline.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct AnimationBoard
+    {
+        char const* name;
+        int width;
+        int height;
+        int mines;
+    };
+
+    const AnimationBoard AnimationBoards[] =
+    {
+        { "expert", 30, 16, 99 },
+        { "256x256", 256, 256, 13107 },
+        { "1024x1024", 1024, 1024, 209715 },
+        { "4096x4096", 4096, 4096, 3355443 },
+    };
+
+    // A 60Hz display.
+    const auto FrameTime = std::chrono::microseconds(16667);
+
+    // Loses a game the way a player would, by sweeping a mine after the first
+    // sweep, and returns the rings around that mine.
+    void LoseGame(MinesweeperGame& game, AnimationBoard const& board, MineRings& rings)
+    {
+        game.NewGame(board.width, board.height, board.mines, 1);
+        game.Press(board.width / 2, board.height / 2, false);
+        auto tileCount = board.width * board.height;
+        auto mine = 0;
+        while (mine < tileCount && !game.IsMine(mine))
+        {
+            mine++;
+        }
+        auto x = game.Indices().ComputeXFromIndex(mine);
+        auto y = game.Indices().ComputeYFromIndex(mine);
+        game.Press(x, y, false);
+        game.ComputeMineRings(x, y, rings);
+    }
+
+    double Percentile(std::vector<double>& values, double percentile)
+    {
+        std::sort(values.begin(), values.end());
+        return values.empty() ? 0.0 : values[std::min(values.size() - 1, static_cast<size_t>(values.size() * percentile / 100.0))];
+    }
+}
+
+void RunAnimationBenchmark()
+{
+    MinesweeperGame game;
+    MineRings rings;
+    ManualAnimationClock clock;
+    MineTimeline timeline(clock);
+    std::vector<double> tickTimes;
+    std::vector<uint8_t> timesStarted;
+    std::vector<float> lastScales;
+    for (auto& board : AnimationBoards)
+    {
+        LoseGame(game, board, rings);
+        auto mineCount = rings.MineIndices().size();
+        auto ringCount = rings.MinesPerRing().size();
+        PrintResult("animation", board.name, "mines", static_cast<double>(mineCount));
+        PrintResult("animation", board.name, "rings", static_cast<double>(ringCount));
+
+        // Input stays locked for exactly as long as the schedule says, no
+        // matter whether the animation was ticked.
+        auto expected = MineTimeline::RingDelay * static_cast<int64_t>(ringCount - 1) + MineTimeline::MineDuration;
+        timeline.Start(rings);
+        clock.Advance(expected - std::chrono::nanoseconds(1));
+        auto lockedUntilEnd = timeline.IsPlaying();
+        clock.Advance(std::chrono::nanoseconds(1));
+        auto unlockedAtEnd = !timeline.IsPlaying();
+        PrintResult("animation", board.name, "locked_ms", std::chrono::duration<double, std::milli>(expected).count());
+        PrintResult("animation", board.name, "lock_matches_schedule", lockedUntilEnd && unlockedAtEnd ? 1.0 : 0.0);
+
+        // Play it a frame at a time, keeping what each mine was last drawn as.
+        tickTimes.clear();
+        timesStarted.assign(board.width * board.height, 0);
+        lastScales.assign(board.width * board.height, 0.0f);
+        size_t maximumActiveMines = 0;
+        size_t activeMines = 0;
+        uint64_t frames = 0;
+        timeline.Start(rings);
+        while (true)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto more = timeline.Tick();
+            tickTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            if (!more)
+            {
+                break;
+            }
+
+            size_t frameMines = 0;
+            auto& mineIndices = timeline.MineIndices();
+            for (auto& ring : timeline.Frame())
+            {
+                for (auto i = ring.firstMine; i < ring.firstMine + ring.mineCount; i++)
+                {
+                    timesStarted[mineIndices[i]] += ring.started ? 1 : 0;
+                    lastScales[mineIndices[i]] = ring.scale;
+                }
+                frameMines += ring.mineCount;
+            }
+            maximumActiveMines = std::max(maximumActiveMines, frameMines);
+            activeMines += frameMines;
+            frames++;
+            clock.Advance(FrameTime);
+        }
+
+        // Every mine was brought to the top once and left at its normal size.
+        auto consistent = true;
+        for (auto index : rings.MineIndices())
+        {
+            consistent = consistent && timesStarted[index] == 1 && lastScales[index] == 1.0f;
+        }
+
+        PrintResult("animation", board.name, "frames", static_cast<double>(frames));
+        PrintResult("animation", board.name, "active_mines_max", static_cast<double>(maximumActiveMines));
+        PrintResult("animation", board.name, "active_mines_mean", frames == 0 ? 0.0 : static_cast<double>(activeMines) / frames);
+        PrintResult("animation", board.name, "tick_us_p50", Percentile(tickTimes, 50.0));
+        PrintResult("animation", board.name, "tick_us_p99", Percentile(tickTimes, 99.0));
+        PrintResult("animation", board.name, "frames_consistent", consistent ? 1.0 : 0.0);
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+struct BoardPreset
+{
+    char const* name;
+    int width;
+    int height;
+    int mines;
+};
+
+// The classic difficulty levels.
+static const BoardPreset ClassicPresets[] =
+{
+    { "beginner", 9, 9, 10 },
+    { "intermediate", 16, 16, 40 },
+    { "expert", 30, 16, 99 },
+};
+
+// Every result is printed as one comma separated line,
+// "benchmark,board,metric,value", so runs can be diffed and graphed.
+void PrintResult(char const* benchmark, char const* board, char const* metric, double value);
+
+// Compares MineBitBoard's neighbor counts, on both its AVX2 and scalar
+// paths, against MinesweeperGame::GetSurroundingMineCount on random boards
+// of every density, with odd heights and heights on either side of a 64
+// tile word. Returns false if any tile disagrees.
+bool RunNeighborCountCheck();
+
+void RunSolverBenchmark();
+void RunProbabilityBenchmark();
+void RunNoGuessBenchmark();
+
+// Places mines on boards from 1% to 99% mines with GenerateMineLayout and
+// with the draw-until-free placement it replaced. Prints the time per
+// layout and per mine for each density.
+void RunDensityBenchmark();
+
+// Presses into openings of 10 to 10^7 tiles walled in by mines, with a bare
+// SpanFloodFill, with a ParallelFloodFill on 1 to maximumThreads threads and
+// through MinesweeperGame::Press. Prints revealed tiles a second for each
+// size. A maximumThreads of 0 goes up to one per hardware thread.
+void RunOpeningBenchmark(int maximumThreads);
+
+const int DefaultMicroMaximumSide = 8192;
+// Times each of MinesweeperGame's hot paths on its own, on random boards at
+// several densities and on pathological layouts, skipping boards wider or
+// taller than maximumSide.
+void RunMicroBenchmark(int maximumSide);
+
+// Draws boards with SoftwareRenderer, a whole frame and then only the tiles
+// each press changed. The expert board's last frame is written to ppmPath
+// unless it's empty.
+void RunRenderBenchmark(std::string const& ppmPath);
+
+// Replays synthetic mouse and pen streams through the pointer handling,
+// once per input and once through PointerInputQueue a frame at a time.
+void RunInputBenchmark();
+
+// Plays boards with history kept, then walks it back and forth. Prints what
+// each version costs and how long undo, redo and forks take.
+void RunHistoryBenchmark();
+
+// Plays the game over animation on a ManualAnimationClock at 60Hz. Prints
+// how many mines each frame touches, what a tick costs and whether input
+// stays locked for exactly as long as the schedule says.
+void RunAnimationBenchmark();
+
+// Plays the classic presets to a win with PresetBoard and again with the
+// runtime-sized path. Prints the first press (which places the mines) and
+// the rest of each game for both, and whether they ended up the same.
+void RunPresetBenchmark();
+
+// Runs a sweep, neighbor count generation and the game over ring search on
+// large boards stored column major (the game's order) and in 8x8 and 16x16
+// blocks. Prints throughput and the misses a modelled L1 and L2 take for
+// each order, and whether every order got the same results. This only
+// studies whether a blocked order would pay off: the blocked orders exist
+// in the benchmark alone and the game always stores its board column major.
+void RunLayoutBenchmark();
+
+// Runs neighbor count generation, a sweep, single tile presses and snapshot
+// packing on large boards stored as the game's two byte arrays and as one
+// packed byte a tile (a mine bit, a 4-bit count and 2 bits of state). Prints
+// throughput for each and whether both got the same results. Like the
+// layout benchmark, the packed record exists in the benchmark alone.
+void RunRecordBenchmark();
+
+#ifdef _WIN32
+const int DefaultHostMaximumSessions = 4096;
+// Starts a GameHost and plays expert games against it over loopback from
+// more and more sessions, up to maximumSessions, each pressing four times a
+// second. Prints latency per level and how many sessions each worker kept
+// under a 10ms p99.
+void RunHostBenchmark(int maximumSessions);
+#endif
+
+const uint64_t DefaultEndlessPresses = 100000;
+// Explores an EndlessBoard by random walking and pressing pressCount tiles,
+// streaming every opening out a budget of tiles at a time. Prints revealed
+// tiles a second, what each Sweep or ContinueSweep call cost, and how much
+// chunk memory the explored area took.
+void RunEndlessBenchmark(uint64_t pressCount);
+
+const uint64_t DefaultSelfPlayGames = 20000;
+// Plays gameCount games with the named SelfPlayPolicy on every hardware
+// thread. Returns false if there is no such policy.
+bool RunSelfPlayBenchmark(std::string const& policyName, uint64_t gameCount);
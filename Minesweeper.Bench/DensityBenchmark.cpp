@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct BoardSize
+    {
+        int width;
+        int height;
+    };
+
+    const BoardSize BoardSizes[] =
+    {
+        { 30, 16 },
+        { 256, 256 },
+        { 1024, 1024 },
+    };
+    const int DensityPercents[] = { 1, 5, 10, 20, 30, 40, 50, 60, 70, 80, 90, 95, 99 };
+
+    // Every layout is generated at least MinimumRuns times and then until
+    // MeasureTime is used up or it has run MaximumRuns times.
+    const size_t MinimumRuns = 3;
+    const size_t MaximumRuns = 1000;
+    const auto MeasureTime = std::chrono::milliseconds(200);
+
+    volatile int64_t g_sink = 0;
+
+    // Placing a mine by drawing tiles until a free one comes up, the way
+    // mines were placed before GenerateMineLayout. Kept here so the sweep
+    // shows what it replaced: every mine costs more draws as the board fills.
+    void GenerateMineLayoutByRejection(uint64_t seed, int numMines, int excludeIndex, MineBitBoard& mines)
+    {
+        std::mt19937_64 random(seed);
+        auto height = mines.Height();
+        std::uniform_int_distribution<int> tiles(0, mines.Width() * height - 1);
+        for (auto placed = 0; placed < numMines; placed++)
+        {
+            while (true)
+            {
+                auto index = tiles(random);
+                if (index != excludeIndex && !mines.Test(index / height, index % height))
+                {
+                    mines.Set(index / height, index % height);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Times generate on a cleared board over and over and prints the median
+    // run, and what that is per mine.
+    template <typename Generate>
+    void MeasureGenerate(char const* path, std::string const& board, int width, int height, int numMines, Generate&& generate)
+    {
+        auto excludeIndex = (width / 2) * height + height / 2;
+        MineBitBoard mines;
+        uint64_t seed = 1;
+        std::vector<double> times;
+        auto measureStart = std::chrono::steady_clock::now();
+        while (times.size() < MinimumRuns ||
+            (times.size() < MaximumRuns && std::chrono::steady_clock::now() - measureStart < MeasureTime))
+        {
+            mines.Reset(width, height);
+            auto start = std::chrono::steady_clock::now();
+            generate(seed++, numMines, excludeIndex, mines);
+            times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        g_sink = g_sink + (mines.Test(0, 0) ? 1 : 0);
+
+        auto median = times[times.size() / 2];
+        PrintResult(path, board.c_str(), "ns_p50", median);
+        PrintResult(path, board.c_str(), "ns_per_mine_p50", median / std::max(numMines, 1));
+    }
+}
+
+void RunDensityBenchmark()
+{
+    for (auto& size : BoardSizes)
+    {
+        auto tileCount = size.width * size.height;
+        for (auto density : DensityPercents)
+        {
+            // One tile is always left for the first click.
+            auto numMines = std::min(static_cast<int>(static_cast<int64_t>(tileCount) * density / 100), tileCount - 1);
+            char board[64];
+            snprintf(board, sizeof(board), "%dx%d_%dpct", size.width, size.height, density);
+
+            PrintResult("density_floyd", board, "mines", static_cast<double>(numMines));
+            MeasureGenerate("density_floyd", board, size.width, size.height, numMines, GenerateMineLayout);
+            MeasureGenerate("density_rejection", board, size.width, size.height, numMines, GenerateMineLayoutByRejection);
+        }
+    }
+}
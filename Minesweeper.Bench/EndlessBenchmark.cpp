@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "EndlessBoard.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    // Half of expert's density (about 20%), so openings often outgrow a
+    // single call and have to be streamed. Much sparser than this and an
+    // opening may never end.
+    const double MineDensity = 0.10;
+    // Between presses the explorer moves up to this far along each axis.
+    const int WalkStep = 48;
+    // Tiles a single Sweep or ContinueSweep call may reveal, about what a
+    // frame would be given.
+    const size_t SweepBudget = 4096;
+
+    volatile int64_t g_sink = 0;
+}
+
+void RunEndlessBenchmark(uint64_t pressCount)
+{
+    // The explorer random walks away from the origin and presses wherever it
+    // lands. It reads the layout to skip mines and revealed tiles, so every
+    // press opens something and the explored area only grows.
+    EndlessBoard board(1, MineDensity);
+    std::mt19937_64 random(1);
+    std::uniform_int_distribution<int> step(-WalkStep, WalkStep);
+    int64_t x = 0;
+    int64_t y = 0;
+
+    std::vector<EndlessTileCoordinate> revealedTiles;
+    std::vector<double> callTimes;
+    uint64_t tilesRevealed = 0;
+    uint64_t presses = 0;
+    uint64_t continuedSweeps = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (presses < pressCount)
+    {
+        x += step(random);
+        y += step(random);
+        if (board.IsMine(x, y) || board.GetState(x, y) != MineState::Empty)
+        {
+            continue;
+        }
+
+        auto callStart = std::chrono::steady_clock::now();
+        revealedTiles.clear();
+        board.Sweep(x, y, revealedTiles, SweepBudget);
+        callTimes.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - callStart).count());
+        tilesRevealed += revealedTiles.size();
+        presses++;
+
+        // Whatever didn't fit streams out over the following calls.
+        while (board.HasPendingSweep())
+        {
+            callStart = std::chrono::steady_clock::now();
+            revealedTiles.clear();
+            board.ContinueSweep(revealedTiles, SweepBudget);
+            callTimes.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - callStart).count());
+            tilesRevealed += revealedTiles.size();
+            continuedSweeps++;
+        }
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::sort(callTimes.begin(), callTimes.end());
+    g_sink = g_sink + static_cast<int64_t>(tilesRevealed);
+
+    // Tile states and neighbor counts are a byte each.
+    auto chunkBytes = static_cast<double>(EndlessBoard::ChunkSize) * EndlessBoard::ChunkSize * 2;
+    char name[64];
+    snprintf(name, sizeof(name), "density_%d", static_cast<int>(MineDensity * 100));
+    PrintResult("endless", name, "presses", static_cast<double>(presses));
+    PrintResult("endless", name, "continued_sweeps", static_cast<double>(continuedSweeps));
+    PrintResult("endless", name, "tiles_revealed", static_cast<double>(tilesRevealed));
+    PrintResult("endless", name, "tiles_per_sec", tilesRevealed / seconds);
+    PrintResult("endless", name, "call_ns_p50", callTimes[callTimes.size() / 2]);
+    PrintResult("endless", name, "call_ns_p99", callTimes[callTimes.size() * 99 / 100]);
+    PrintResult("endless", name, "call_ns_max", callTimes.back());
+    PrintResult("endless", name, "chunks", static_cast<double>(board.ChunkCount()));
+    PrintResult("endless", name, "bytes_per_revealed_tile", board.ChunkCount() * chunkBytes / std::max<uint64_t>(tilesRevealed, 1));
+}
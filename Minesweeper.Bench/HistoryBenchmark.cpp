@@ -0,0 +1,179 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct HistoryBoard
+    {
+        char const* name;
+        int width;
+        int height;
+        int mines;
+    };
+
+    const HistoryBoard HistoryBoards[] =
+    {
+        { "expert", 30, 16, 99 },
+        { "256x256", 256, 256, 13107 },
+        { "1024x1024", 1024, 1024, 209715 },
+        { "4096x4096", 4096, 4096, 3355443 },
+    };
+
+    const int PressesPerBoard = 500;
+
+    // Keeps the state of every tile from the batches it's given, the way a
+    // UI would, so it can be checked against the game.
+    class BoardMirror : public TileUpdateSink
+    {
+    public:
+        void Reset(size_t tileCount) { m_states.assign(tileCount, MineState::Empty); }
+        void ApplyTileUpdates(TileUpdate const* updates, size_t count) override
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                m_states[updates[i].index] = updates[i].state;
+            }
+        }
+        bool Matches(MinesweeperGame const& game) const
+        {
+            return std::memcmp(m_states.data(), game.MineStates(), m_states.size()) == 0;
+        }
+
+    private:
+        std::vector<MineState> m_states;
+    };
+
+    double MicrosecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double Median(std::vector<double>& values)
+    {
+        std::sort(values.begin(), values.end());
+        return values.empty() ? 0.0 : values[values.size() / 2];
+    }
+
+    // The same presses every time for a board. Mines are marked instead of
+    // swept, so every game lasts all of its presses.
+    void PlayPresses(MinesweeperGame& game, std::vector<double>& pressTimes)
+    {
+        RandomGenerator random(1);
+        auto tileCount = static_cast<uint64_t>(game.Width()) * game.Height();
+        pressTimes.clear();
+        game.Press(game.Width() / 2, game.Height() / 2, false);
+        for (auto press = 0; press < PressesPerBoard && !game.IsGameOver(); press++)
+        {
+            auto index = static_cast<int>(random.NextBelow(tileCount));
+            auto mark = game.Header().mineGenerationState == MineGenerationState::Generated && game.IsMine(index);
+            auto start = std::chrono::steady_clock::now();
+            game.Press(index / game.Height(), index % game.Height(), mark || random.NextBelow(8) == 0);
+            pressTimes.push_back(MicrosecondsSince(start));
+        }
+    }
+}
+
+void RunHistoryBenchmark()
+{
+    std::vector<double> times;
+    for (auto& board : HistoryBoards)
+    {
+        auto tileCount = static_cast<size_t>(board.width) * board.height;
+
+        // The cost of keeping versions is whatever a press takes over this.
+        {
+            MinesweeperGame game;
+            game.NewGame(board.width, board.height, board.mines, 1);
+            PlayPresses(game, times);
+            PrintResult("history", board.name, "press_us_p50", Median(times));
+        }
+
+        MinesweeperGame game;
+        BoardMirror mirror;
+        game.SetKeepHistory(true);
+        game.SetTileUpdateSink(&mirror);
+        game.NewGame(board.width, board.height, board.mines, 1);
+        mirror.Reset(tileCount);
+        auto startHash = game.ComputeStateHash();
+        PlayPresses(game, times);
+        PrintResult("history", board.name, "press_history_us_p50", Median(times));
+        auto endHash = game.ComputeStateHash();
+
+        // What each version costs on top of the one before it.
+        std::vector<BoardVersion> versions;
+        while (game.CanUndo())
+        {
+            versions.push_back(game.CurrentVersion());
+            game.Undo();
+        }
+        versions.push_back(game.CurrentVersion());
+        size_t versionBytes = 0;
+        size_t maximumVersionBytes = 0;
+        for (size_t i = 0; i + 1 < versions.size(); i++)
+        {
+            auto bytes = versions[i].BytesNotSharedWith(versions[i + 1]);
+            versionBytes += bytes;
+            maximumVersionBytes = std::max(maximumVersionBytes, bytes);
+        }
+        auto versionCount = std::max<size_t>(1, versions.size() - 1);
+        versions.clear();
+        PrintResult("history", board.name, "board_bytes", static_cast<double>(tileCount * 2));
+        PrintResult("history", board.name, "version_bytes_avg", static_cast<double>(versionBytes) / versionCount);
+        PrintResult("history", board.name, "version_bytes_max", static_cast<double>(maximumVersionBytes));
+
+        // Walk the whole history back and forth, timing each step.
+        times.clear();
+        while (game.CanRedo())
+        {
+            auto start = std::chrono::steady_clock::now();
+            game.Redo();
+            times.push_back(MicrosecondsSince(start));
+        }
+        PrintResult("history", board.name, "redo_us_p50", Median(times));
+        auto redoneHash = game.ComputeStateHash();
+        auto redoneMatches = mirror.Matches(game);
+        times.clear();
+        while (game.CanUndo())
+        {
+            auto start = std::chrono::steady_clock::now();
+            game.Undo();
+            times.push_back(MicrosecondsSince(start));
+        }
+        PrintResult("history", board.name, "undo_us_p50", Median(times));
+        auto undoneHash = game.ComputeStateHash();
+        auto undoneMatches = mirror.Matches(game);
+        while (game.Redo())
+        {
+        }
+
+        // Fork, try a press, and go back to the fork.
+        auto start = std::chrono::steady_clock::now();
+        auto fork = game.CurrentVersion();
+        PrintResult("history", board.name, "fork_us", MicrosecondsSince(start));
+        auto index = 0;
+        while (game.MineStates()[index] != MineState::Empty || game.IsMine(index))
+        {
+            index++;
+        }
+        game.Press(index / board.height, index % board.height, false);
+        start = std::chrono::steady_clock::now();
+        game.RestoreVersion(fork);
+        PrintResult("history", board.name, "fork_restore_us", MicrosecondsSince(start));
+
+        auto same = redoneHash == endHash && undoneHash == startHash && redoneMatches && undoneMatches &&
+            game.ComputeStateHash() == endHash && mirror.Matches(game);
+        PrintResult("history", board.name, "same_result", same ? 1.0 : 0.0);
+    }
+}
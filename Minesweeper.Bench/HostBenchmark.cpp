@@ -0,0 +1,257 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "GameProfile.h"
+#include "HostProtocol.h"
+#include "GameHost.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    // Every player presses about as fast as a quick human, four times a
+    // second, on expert boards. Players start spread over one think time so
+    // they don't all press at once.
+    const auto ThinkTime = std::chrono::milliseconds(250);
+    const auto LevelTime = std::chrono::seconds(5);
+    const int BoardWidth = 30;
+    const int BoardHeight = 16;
+    const int BoardMines = 99;
+
+    // A level counts towards sessions per core while p99 stays under this.
+    const uint64_t LatencyBudgetNanoseconds = 10 * 1000 * 1000;
+
+    struct ClientSession
+    {
+        SOCKET socket = INVALID_SOCKET;
+        RandomGenerator random{ 0 };
+        std::chrono::steady_clock::time_point nextSend;
+        std::chrono::steady_clock::time_point sentAt;
+        bool waiting = false;
+        bool needsGame = true;
+        uint64_t games = 0;
+        std::vector<uint8_t> input;
+    };
+
+    struct ClientResult
+    {
+        LatencyHistogram latency;
+        uint64_t responses = 0;
+        uint64_t errors = 0;
+        bool connected = true;
+    };
+
+    SOCKET Connect(uint16_t port)
+    {
+        auto socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if (socket == INVALID_SOCKET || connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR)
+        {
+            if (socket != INVALID_SOCKET)
+            {
+                closesocket(socket);
+            }
+            return INVALID_SOCKET;
+        }
+        BOOL noDelay = TRUE;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char const*>(&noDelay), sizeof(noDelay));
+        return socket;
+    }
+
+    // Mostly sweeps, some flags and the odd snapshot, like a client that
+    // saves now and then. A game that ended is followed by a new one.
+    void WriteNextRequest(ClientSession& session, uint64_t sessionIndex, std::vector<uint8_t>& request)
+    {
+        request.clear();
+        if (session.needsGame)
+        {
+            WriteNewGameRequest(request, BoardWidth, BoardHeight, BoardMines, (sessionIndex << 32) + session.games++);
+            return;
+        }
+
+        auto kind = session.random.NextBelow(100);
+        if (kind < 5)
+        {
+            WriteSnapshotRequest(request);
+        }
+        else
+        {
+            auto index = static_cast<int>(session.random.NextBelow(BoardWidth * BoardHeight));
+            WritePressRequest(request, kind < 15, index / BoardHeight, index % BoardHeight);
+        }
+    }
+
+    // Drives sessionCount sessions from one thread until endTime.
+    void RunClients(uint16_t port, uint64_t firstSession, int sessionCount, std::chrono::steady_clock::time_point endTime, ClientResult& result)
+    {
+        std::vector<ClientSession> sessions(sessionCount);
+        auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < sessionCount; i++)
+        {
+            auto& session = sessions[i];
+            session.socket = Connect(port);
+            session.random = RandomGenerator(firstSession + i + 1);
+            session.nextSend = start + ThinkTime * i / sessionCount;
+            result.connected = result.connected && session.socket != INVALID_SOCKET;
+        }
+        if (!result.connected)
+        {
+            for (auto& session : sessions)
+            {
+                closesocket(session.socket);
+            }
+            return;
+        }
+
+        std::vector<WSAPOLLFD> polls(sessionCount);
+        std::vector<uint8_t> request;
+        std::vector<uint8_t> buffer(64 * 1024);
+        auto now = start;
+        while (now < endTime)
+        {
+            for (auto i = 0; i < sessionCount; i++)
+            {
+                auto& session = sessions[i];
+                if (!session.waiting && session.nextSend <= now)
+                {
+                    WriteNextRequest(session, firstSession + i, request);
+                    send(session.socket, reinterpret_cast<char const*>(request.data()), static_cast<int>(request.size()), 0);
+                    session.waiting = true;
+                    session.sentAt = now;
+                }
+                polls[i].fd = session.socket;
+                polls[i].events = POLLRDNORM;
+                polls[i].revents = 0;
+            }
+
+            WSAPoll(polls.data(), static_cast<ULONG>(polls.size()), 1);
+            now = std::chrono::steady_clock::now();
+            for (auto i = 0; i < sessionCount; i++)
+            {
+                if ((polls[i].revents & POLLRDNORM) == 0)
+                {
+                    continue;
+                }
+
+                auto& session = sessions[i];
+                auto received = recv(session.socket, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0);
+                if (received <= 0)
+                {
+                    continue;
+                }
+                session.input.insert(session.input.end(), buffer.begin(), buffer.begin() + received);
+
+                HostFrame frame = {};
+                size_t used = 0;
+                while (ReadHostFrame(session.input.data() + used, session.input.size() - used, frame))
+                {
+                    used += frame.frameSize;
+                    result.latency.Record(now - session.sentAt);
+                    result.responses++;
+                    session.waiting = false;
+                    session.nextSend = session.sentAt + ThinkTime;
+
+                    if (frame.kind == HostMessageKind::NewGame)
+                    {
+                        session.needsGame = false;
+                    }
+                    else if (frame.kind == HostMessageKind::Error)
+                    {
+                        result.errors++;
+                        session.needsGame = true;
+                    }
+                    else if (frame.kind == HostMessageKind::Sweep || frame.kind == HostMessageKind::Flag)
+                    {
+                        auto pressResult = static_cast<PressResult>(frame.payload[0]);
+                        session.needsGame = pressResult == PressResult::HitMine || pressResult == PressResult::Won;
+                    }
+                }
+                session.input.erase(session.input.begin(), session.input.begin() + used);
+            }
+        }
+
+        for (auto& session : sessions)
+        {
+            closesocket(session.socket);
+        }
+    }
+
+    char const* LevelName(int sessionCount)
+    {
+        static char name[32];
+        snprintf(name, sizeof(name), "%d_sessions", sessionCount);
+        return name;
+    }
+}
+
+void RunHostBenchmark(int maximumSessions)
+{
+    // The host starts Winsock, which the clients use too.
+    GameHost host;
+    auto clientThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency() / 2));
+    PrintResult("host", "all", "workers", host.WorkerCount());
+    PrintResult("host", "all", "client_threads", clientThreads);
+
+    auto sessionsWithinBudget = 0;
+    for (auto sessionCount = 64; sessionCount <= maximumSessions; sessionCount *= 4)
+    {
+        std::vector<ClientResult> results(clientThreads);
+        std::vector<std::thread> threads;
+        auto endTime = std::chrono::steady_clock::now() + LevelTime;
+        auto firstSession = 0;
+        for (auto i = 0; i < clientThreads; i++)
+        {
+            auto threadSessions = sessionCount / clientThreads + (i < sessionCount % clientThreads ? 1 : 0);
+            threads.emplace_back(RunClients, host.Port(), static_cast<uint64_t>(firstSession), threadSessions, endTime, std::ref(results[i]));
+            firstSession += threadSessions;
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        auto& total = results[0];
+        for (size_t i = 1; i < results.size(); i++)
+        {
+            total.latency.Merge(results[i].latency);
+            total.responses += results[i].responses;
+            total.errors += results[i].errors;
+            total.connected = total.connected && results[i].connected;
+        }
+        if (!total.connected)
+        {
+            fprintf(stderr, "Couldn't connect %d sessions to the host.\n", sessionCount);
+            break;
+        }
+
+        auto level = LevelName(sessionCount);
+        auto seconds = std::chrono::duration<double>(LevelTime).count();
+        PrintResult("host", level, "requests_per_sec", total.responses / seconds);
+        PrintResult("host", level, "latency_us_p50", total.latency.Percentile(50.0) / 1000.0);
+        PrintResult("host", level, "latency_us_p99", total.latency.Percentile(99.0) / 1000.0);
+        PrintResult("host", level, "errors", static_cast<double>(total.errors));
+        if (total.latency.Percentile(99.0) <= LatencyBudgetNanoseconds)
+        {
+            sessionsWithinBudget = sessionCount;
+        }
+
+        // Let the host close the level's sessions before the next one.
+        while (host.ActiveSessions() > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    PrintResult("host", "all", "sessions_per_core", static_cast<double>(sessionsWithinBudget) / host.WorkerCount());
+}
@@ -0,0 +1,225 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "PointerInputQueue.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    // The layout CompUI and VisualGrid use, in a typical window.
+    const float TileSize = 25.0f;
+    const float TileMargin = 2.5f;
+    const float BoardMargin = 100.0f;
+    const float WindowWidth = 1280.0f;
+    const float WindowHeight = 720.0f;
+
+    struct InputStream
+    {
+        char const* name;
+        int movesPerSecond;
+    };
+
+    const InputStream InputStreams[] =
+    {
+        { "mouse_125hz", 125 },
+        { "pen_240hz", 240 },
+        { "mouse_1000hz", 1000 },
+        { "mouse_8000hz", 8000 },
+    };
+    const int FramesPerSecond = 60;
+    const int PressesPerSecond = 4;
+    const int SecondsOfInput = 10;
+
+    struct TimedInput
+    {
+        double time;
+        PointerInput input;
+    };
+
+    // Does what Minesweeper does with each input minus the composition
+    // calls: the scaled hit test, the revealed check, the selection and the
+    // press. Selection changes are only counted.
+    class InputHandler
+    {
+    public:
+        InputHandler()
+        {
+            m_game.NewGame(30, 16, 99, 1);
+        }
+
+        void Move(float x, float y)
+        {
+            m_moves++;
+            std::optional<std::pair<int, int>> selection;
+            if (auto tile = HitTest(x, y))
+            {
+                if (m_game.MineStates()[m_game.Indices().ComputeIndex(tile->first, tile->second)] != MineState::Revealed)
+                {
+                    selection = tile;
+                }
+            }
+            SelectTile(selection);
+        }
+
+        void Press(bool isRightButton, bool isEraser)
+        {
+            if (m_game.IsGameOver())
+            {
+                m_game.NewGame(30, 16, 99, ++m_seed);
+            }
+            if (m_selection)
+            {
+                m_game.Press(m_selection->first, m_selection->second, isRightButton || isEraser);
+                if (m_game.IsGameOver())
+                {
+                    SelectTile(std::nullopt);
+                }
+            }
+        }
+
+        uint64_t Moves() const { return m_moves; }
+        uint64_t SelectionChanges() const { return m_selectionChanges; }
+        uint64_t StateHash() const { return m_game.ComputeStateHash() ^ m_seed; }
+
+    private:
+        std::optional<std::pair<int, int>> HitTest(float x, float y) const
+        {
+            // The same math as CompUI::HitTest and VisualGrid::HitTest.
+            auto boardWidth = (TileSize + TileMargin) * m_game.Width();
+            auto boardHeight = (TileSize + TileMargin) * m_game.Height();
+            auto scale = WindowWidth / (boardWidth + BoardMargin);
+            if (WindowWidth / WindowHeight > (boardWidth + BoardMargin) / (boardHeight + BoardMargin))
+            {
+                scale = WindowHeight / (boardHeight + BoardMargin);
+            }
+            auto boardX = (x - (WindowWidth - boardWidth * scale) / 2.0f) / scale;
+            auto boardY = (y - (WindowHeight - boardHeight * scale) / 2.0f) / scale;
+            auto tileX = static_cast<int>(boardX / (TileSize + TileMargin));
+            auto tileY = static_cast<int>(boardY / (TileSize + TileMargin));
+            if (boardX < 0 || boardY < 0 || !m_game.Indices().IsInBounds(tileX, tileY))
+            {
+                return std::nullopt;
+            }
+            return std::make_pair(tileX, tileY);
+        }
+
+        void SelectTile(std::optional<std::pair<int, int>> const& selection)
+        {
+            if (selection != m_selection)
+            {
+                m_selection = selection;
+                m_selectionChanges++;
+            }
+        }
+
+    private:
+        MinesweeperGame m_game;
+        uint64_t m_seed = 1;
+        std::optional<std::pair<int, int>> m_selection;
+        uint64_t m_moves = 0;
+        uint64_t m_selectionChanges = 0;
+    };
+
+    // Moves sweep the window in a slow figure eight, with presses and frame
+    // boundaries at fixed rates. Everything is sorted by time.
+    void BuildInput(int movesPerSecond, std::vector<TimedInput>& inputs, std::vector<double>& frameTimes)
+    {
+        inputs.clear();
+        for (auto i = 0; i < movesPerSecond * SecondsOfInput; i++)
+        {
+            auto time = static_cast<double>(i) / movesPerSecond;
+            auto x = static_cast<float>(WindowWidth * (0.5 + 0.45 * std::sin(time * 1.3)));
+            auto y = static_cast<float>(WindowHeight * (0.5 + 0.45 * std::sin(time * 2.6)));
+            inputs.push_back({ time, { PointerInputKind::Move, x, y, false, false } });
+        }
+        for (auto i = 0; i < PressesPerSecond * SecondsOfInput; i++)
+        {
+            // Just off the move times, so every press follows a move.
+            auto time = (i + 0.5) / PressesPerSecond + 1e-7;
+            inputs.push_back({ time, { PointerInputKind::Press, 0.0f, 0.0f, i % 5 == 0, false } });
+        }
+        std::stable_sort(inputs.begin(), inputs.end(), [](TimedInput const& a, TimedInput const& b) { return a.time < b.time; });
+
+        frameTimes.clear();
+        for (auto i = 1; i <= FramesPerSecond * SecondsOfInput; i++)
+        {
+            frameTimes.push_back(static_cast<double>(i) / FramesPerSecond);
+        }
+    }
+
+    void Handle(InputHandler& handler, PointerInput const& input)
+    {
+        if (input.kind == PointerInputKind::Move)
+        {
+            handler.Move(input.x, input.y);
+        }
+        else
+        {
+            handler.Press(input.isRightButton, input.isEraser);
+        }
+    }
+}
+
+void RunInputBenchmark()
+{
+    std::vector<TimedInput> inputs;
+    std::vector<double> frameTimes;
+    std::vector<PointerInput> frameInputs;
+    for (auto& stream : InputStreams)
+    {
+        BuildInput(stream.movesPerSecond, inputs, frameTimes);
+
+        // Every input handled as it arrives, the way the hosts used to.
+        InputHandler direct;
+        auto start = std::chrono::steady_clock::now();
+        for (auto& timed : inputs)
+        {
+            Handle(direct, timed.input);
+        }
+        auto directSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Input queued and handled once per frame.
+        InputHandler queued;
+        PointerInputQueue queue;
+        size_t next = 0;
+        start = std::chrono::steady_clock::now();
+        for (auto frameTime : frameTimes)
+        {
+            for (; next < inputs.size() && inputs[next].time < frameTime; next++)
+            {
+                auto& input = inputs[next].input;
+                if (input.kind == PointerInputKind::Move)
+                {
+                    queue.Move(input.x, input.y);
+                }
+                else
+                {
+                    queue.Press(input.isRightButton, input.isEraser);
+                }
+            }
+            queue.Take(frameInputs);
+            for (auto& input : frameInputs)
+            {
+                Handle(queued, input);
+            }
+        }
+        auto queuedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        PrintResult("input", stream.name, "direct_us_per_input_second", directSeconds * 1e6 / SecondsOfInput);
+        PrintResult("input", stream.name, "queued_us_per_input_second", queuedSeconds * 1e6 / SecondsOfInput);
+        PrintResult("input", stream.name, "direct_moves_per_second", static_cast<double>(direct.Moves()) / SecondsOfInput);
+        PrintResult("input", stream.name, "queued_moves_per_second", static_cast<double>(queued.Moves()) / SecondsOfInput);
+        PrintResult("input", stream.name, "selection_changes_per_second", static_cast<double>(queued.SelectionChanges()) / SecondsOfInput);
+        // Presses land on the same tiles either way, so the games must match.
+        PrintResult("input", stream.name, "same_result", direct.StateHash() == queued.StateHash() ? 1.0 : 0.0);
+    }
+}
@@ -0,0 +1,417 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct LayoutBoard
+    {
+        char const* name;
+        int width;
+        int height;
+    };
+
+    // Square boards, and boards far taller or wider than they are the other
+    // way, where column major order is at its worst and its best.
+    const LayoutBoard LayoutBoards[] =
+    {
+        { "1024x1024", 1024, 1024 },
+        { "4096x4096", 4096, 4096 },
+        { "256x65536", 256, 65536 },
+        { "65536x256", 65536, 256 },
+    };
+
+    // Few enough mines that a sweep from the middle opens most of the board,
+    // with ragged edges all the way through it.
+    const int MinePercent = 5;
+    const int TimedRuns = 3;
+
+    // The game's own order, x * height + y.
+    struct ColumnMajorOrder
+    {
+        static constexpr char const* Name = "column_major";
+
+        int width;
+        int height;
+
+        ColumnMajorOrder(int width, int height) : width(width), height(height) {}
+
+        size_t TileCount() const { return static_cast<size_t>(width) * height; }
+        size_t Index(int x, int y) const { return static_cast<size_t>(x) * height + y; }
+
+        template <typename Visit>
+        void ForEachTile(Visit&& visit) const
+        {
+            for (auto x = 0; x < width; x++)
+            {
+                for (auto y = 0; y < height; y++)
+                {
+                    visit(x, y, Index(x, y));
+                }
+            }
+        }
+    };
+
+    // Square blocks of BlockSize tiles a side, stored one after another down
+    // each column of blocks, with the tiles inside a block column major too.
+    // An 8x8 block of one byte tiles is exactly one cache line, so a tile's
+    // neighbors on either side are in its own line unless it's on a block's
+    // edge. The last row and column of blocks are padded out.
+    template <int BlockShift, char const* OrderName>
+    struct BlockedOrder
+    {
+        static constexpr char const* Name = OrderName;
+        static constexpr int BlockSize = 1 << BlockShift;
+
+        int width;
+        int height;
+        int blocksWide;
+        int blocksTall;
+
+        BlockedOrder(int width, int height) :
+            width(width),
+            height(height),
+            blocksWide((width + BlockSize - 1) >> BlockShift),
+            blocksTall((height + BlockSize - 1) >> BlockShift)
+        {
+        }
+
+        size_t TileCount() const
+        {
+            return (static_cast<size_t>(blocksWide) * blocksTall) << (BlockShift * 2);
+        }
+
+        size_t Index(int x, int y) const
+        {
+            auto block = static_cast<size_t>(x >> BlockShift) * blocksTall + (y >> BlockShift);
+            return (block << (BlockShift * 2)) | ((x & (BlockSize - 1)) << BlockShift) | (y & (BlockSize - 1));
+        }
+
+        // Block by block, so that scans walk memory front to back.
+        template <typename Visit>
+        void ForEachTile(Visit&& visit) const
+        {
+            for (auto blockX = 0; blockX < width; blockX += BlockSize)
+            {
+                for (auto blockY = 0; blockY < height; blockY += BlockSize)
+                {
+                    for (auto x = blockX; x < std::min(blockX + BlockSize, width); x++)
+                    {
+                        for (auto y = blockY; y < std::min(blockY + BlockSize, height); y++)
+                        {
+                            visit(x, y, Index(x, y));
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    const char Blocked8Name[] = "blocked_8x8";
+    const char Blocked16Name[] = "blocked_16x16";
+    using Blocked8Order = BlockedOrder<3, Blocked8Name>;
+    using Blocked16Order = BlockedOrder<4, Blocked16Name>;
+
+    // A set associative cache with LRU replacement, fed every tile a kernel
+    // reads or writes. Hardware counters can't be read the same way on every
+    // machine the bench runs on, and the model counts the same everywhere.
+    class CacheModel
+    {
+    public:
+        static const size_t LineSize = 64;
+
+        CacheModel(size_t size, int ways) :
+            m_ways(ways),
+            m_sets(size / LineSize / ways),
+            m_lines(m_sets * ways, ~static_cast<uintptr_t>(0)),
+            m_lastUsed(m_sets * ways, 0)
+        {
+        }
+
+        void Touch(void const* address)
+        {
+            auto line = reinterpret_cast<uintptr_t>(address) / LineSize;
+            auto first = (line % m_sets) * m_ways;
+            m_clock++;
+            auto oldest = first;
+            for (auto way = first; way < first + m_ways; way++)
+            {
+                if (m_lines[way] == line)
+                {
+                    m_lastUsed[way] = m_clock;
+                    return;
+                }
+                if (m_lastUsed[way] < m_lastUsed[oldest])
+                {
+                    oldest = way;
+                }
+            }
+            m_lines[oldest] = line;
+            m_lastUsed[oldest] = m_clock;
+            m_misses++;
+        }
+
+        uint64_t Misses() const { return m_misses; }
+
+    private:
+        size_t m_ways;
+        size_t m_sets;
+        std::vector<uintptr_t> m_lines;
+        std::vector<uint64_t> m_lastUsed;
+        uint64_t m_clock = 0;
+        uint64_t m_misses = 0;
+    };
+
+    // What the kernels tell about every tile they touch. Timed runs pass
+    // NoMemoryModel, which compiles away.
+    struct NoMemoryModel
+    {
+        void Touch(void const*) {}
+    };
+
+    // A typical L1 and L2.
+    struct CacheModels
+    {
+        CacheModel l1{ 32 * 1024, 8 };
+        CacheModel l2{ 1024 * 1024, 16 };
+
+        void Touch(void const* address)
+        {
+            l1.Touch(address);
+            l2.Touch(address);
+        }
+    };
+
+    const int NeighborX[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+    const int NeighborY[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+
+    inline bool IsInBounds(int width, int height, int x, int y)
+    {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+
+    // The neighbor count of every tile (-1 for a mine) from one byte per tile
+    // that is 1 for a mine, both in order.
+    template <typename Order, typename Memory>
+    void GenerateCounts(Order const& order, uint8_t const* mines, int8_t* counts, Memory& memory)
+    {
+        order.ForEachTile([&](int x, int y, size_t index)
+        {
+            memory.Touch(mines + index);
+            auto count = 0;
+            for (auto k = 0; k < 8; k++)
+            {
+                auto neighborX = x + NeighborX[k];
+                auto neighborY = y + NeighborY[k];
+                if (IsInBounds(order.width, order.height, neighborX, neighborY))
+                {
+                    auto neighbor = order.Index(neighborX, neighborY);
+                    memory.Touch(mines + neighbor);
+                    count += mines[neighbor];
+                }
+            }
+            memory.Touch(counts + index);
+            counts[index] = mines[index] ? -1 : static_cast<int8_t>(count);
+        });
+    }
+
+    // Sweeps (startX, startY), which must have no mines around it, the way
+    // the game would: every tile around a revealed zero is revealed too.
+    // states is 1 for a revealed tile. Returns how many tiles were revealed.
+    template <typename Order, typename Memory>
+    uint64_t Sweep(Order const& order, int8_t const* counts, uint8_t* states, int startX, int startY, std::vector<std::pair<int, int>>& stack, Memory& memory)
+    {
+        uint64_t revealed = 1;
+        states[order.Index(startX, startY)] = 1;
+        stack.clear();
+        stack.push_back({ startX, startY });
+        while (!stack.empty())
+        {
+            auto tile = stack.back();
+            stack.pop_back();
+            for (auto k = 0; k < 8; k++)
+            {
+                auto neighborX = tile.first + NeighborX[k];
+                auto neighborY = tile.second + NeighborY[k];
+                if (!IsInBounds(order.width, order.height, neighborX, neighborY))
+                {
+                    continue;
+                }
+
+                auto neighbor = order.Index(neighborX, neighborY);
+                memory.Touch(states + neighbor);
+                if (states[neighbor] != 0)
+                {
+                    continue;
+                }
+                states[neighbor] = 1;
+                revealed++;
+                memory.Touch(counts + neighbor);
+                if (counts[neighbor] == 0)
+                {
+                    stack.push_back({ neighborX, neighborY });
+                }
+            }
+        }
+        return revealed;
+    }
+
+    // The search behind the game over animation: every mine, with the ring
+    // around the center it's on, and how many mines each ring has.
+    template <typename Order, typename Memory>
+    void FindRings(Order const& order, int8_t const* counts, int centerX, int centerY, std::vector<std::pair<int, size_t>>& ringMines, std::vector<uint64_t>& minesPerRing, Memory& memory)
+    {
+        ringMines.clear();
+        auto ringCount = std::max({ centerX, order.width - 1 - centerX, centerY, order.height - 1 - centerY }) + 1;
+        minesPerRing.assign(ringCount, 0);
+        order.ForEachTile([&](int x, int y, size_t index)
+        {
+            memory.Touch(counts + index);
+            if (counts[index] < 0)
+            {
+                auto ring = std::max(std::abs(x - centerX), std::abs(y - centerY));
+                ringMines.push_back({ ring, index });
+                minesPerRing[ring]++;
+            }
+        });
+    }
+
+    struct LayoutResults
+    {
+        std::vector<int8_t> counts;
+        uint64_t revealed = 0;
+        std::vector<uint64_t> minesPerRing;
+    };
+
+    template <typename Kernel>
+    double MinimumSeconds(Kernel&& kernel)
+    {
+        auto best = std::numeric_limits<double>::max();
+        for (auto run = 0; run < TimedRuns; run++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            kernel();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    void PrintKernel(char const* kernel, char const* board, char const* orderName, uint64_t tiles, double seconds, CacheModels const& models)
+    {
+        auto benchmark = std::string("layout_") + kernel;
+        auto metric = [orderName](char const* name) { return std::string(orderName) + "_" + name; };
+        auto kiloTiles = tiles / 1000.0;
+        PrintResult(benchmark.c_str(), board, metric("mtiles_per_sec").c_str(), tiles / seconds / 1e6);
+        PrintResult(benchmark.c_str(), board, metric("l1_misses_per_ktile").c_str(), models.l1.Misses() / kiloTiles);
+        PrintResult(benchmark.c_str(), board, metric("l2_misses_per_ktile").c_str(), models.l2.Misses() / kiloTiles);
+    }
+
+    // Runs every kernel on the board in one order, timed and then again
+    // through the cache model, and keeps the results in column major order
+    // so the orders can be compared.
+    template <typename Order>
+    void MeasureOrder(LayoutBoard const& board, MineBitBoard const& mines, int startX, int startY, LayoutResults& results)
+    {
+        Order order(board.width, board.height);
+        std::vector<uint8_t> mineBytes(order.TileCount(), 0);
+        order.ForEachTile([&](int x, int y, size_t index) { mineBytes[index] = mines.Test(x, y) ? 1 : 0; });
+        std::vector<int8_t> counts(order.TileCount(), 0);
+        std::vector<uint8_t> states;
+        std::vector<std::pair<int, int>> stack;
+        std::vector<std::pair<int, size_t>> ringMines;
+        auto tileCount = static_cast<uint64_t>(board.width) * board.height;
+        NoMemoryModel none;
+
+        auto seconds = MinimumSeconds([&]() { GenerateCounts(order, mineBytes.data(), counts.data(), none); });
+        CacheModels countModels;
+        GenerateCounts(order, mineBytes.data(), counts.data(), countModels);
+        PrintKernel("counts", board.name, Order::Name, tileCount, seconds, countModels);
+
+        // The sweep is timed from a covered board each time, the reset isn't.
+        uint64_t revealed = 0;
+        auto sweepSeconds = std::numeric_limits<double>::max();
+        for (auto run = 0; run < TimedRuns; run++)
+        {
+            states.assign(order.TileCount(), 0);
+            auto start = std::chrono::steady_clock::now();
+            revealed = Sweep(order, counts.data(), states.data(), startX, startY, stack, none);
+            sweepSeconds = std::min(sweepSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        states.assign(order.TileCount(), 0);
+        CacheModels sweepModels;
+        Sweep(order, counts.data(), states.data(), startX, startY, stack, sweepModels);
+        PrintKernel("sweep", board.name, Order::Name, revealed, sweepSeconds, sweepModels);
+
+        seconds = MinimumSeconds([&]() { FindRings(order, counts.data(), startX, startY, ringMines, results.minesPerRing, none); });
+        CacheModels ringModels;
+        FindRings(order, counts.data(), startX, startY, ringMines, results.minesPerRing, ringModels);
+        PrintKernel("rings", board.name, Order::Name, tileCount, seconds, ringModels);
+
+        results.counts.resize(static_cast<size_t>(tileCount));
+        ColumnMajorOrder columns(board.width, board.height);
+        order.ForEachTile([&](int x, int y, size_t index) { results.counts[columns.Index(x, y)] = counts[index]; });
+        results.revealed = revealed;
+    }
+}
+
+void RunLayoutBenchmark()
+{
+    MineBitBoard mines;
+    LayoutResults columnMajor;
+    LayoutResults blocked8;
+    LayoutResults blocked16;
+    for (auto& board : LayoutBoards)
+    {
+        auto tileCount = board.width * board.height;
+        mines.Reset(board.width, board.height);
+        GenerateMineLayout(1, tileCount / 100 * MinePercent, (board.width / 2) * board.height + board.height / 2, mines);
+
+        // Start from the first tile with no mines around it, from the middle on.
+        std::vector<int8_t> counts(tileCount);
+        mines.ComputeNeighborCounts(counts.data());
+        auto start = (board.width / 2) * board.height + board.height / 2;
+        while (counts[start] != 0)
+        {
+            start = (start + 1) % tileCount;
+        }
+        auto startX = start / board.height;
+        auto startY = start % board.height;
+
+        MeasureOrder<ColumnMajorOrder>(board, mines, startX, startY, columnMajor);
+
+        // The game doesn't sweep a tile at a time, it fills whole column runs
+        // with SpanFloodFill, which reads column major order front to back.
+        SpanFloodFill floodFill;
+        std::vector<MineState> mineStates;
+        std::vector<TileSpan> revealedSpans;
+        auto spanSeconds = std::numeric_limits<double>::max();
+        for (auto run = 0; run < TimedRuns; run++)
+        {
+            mineStates.assign(tileCount, MineState::Empty);
+            revealedSpans.clear();
+            auto spanStart = std::chrono::steady_clock::now();
+            floodFill.Fill(mineStates.data(), counts.data(), board.width, board.height, startX, startY, revealedSpans);
+            spanSeconds = std::min(spanSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - spanStart).count());
+        }
+        PrintResult("layout_sweep", board.name, "span_fill_mtiles_per_sec", columnMajor.revealed / spanSeconds / 1e6);
+        MeasureOrder<Blocked8Order>(board, mines, startX, startY, blocked8);
+        MeasureOrder<Blocked16Order>(board, mines, startX, startY, blocked16);
+
+        auto same = [&](LayoutResults const& results)
+        {
+            return results.counts == counts && results.revealed == columnMajor.revealed && results.minesPerRing == columnMajor.minesPerRing;
+        };
+        PrintResult("layout", board.name, "tiles_swept", static_cast<double>(columnMajor.revealed));
+        PrintResult("layout", board.name, "same_result", same(columnMajor) && same(blocked8) && same(blocked16) ? 1.0 : 0.0);
+    }
+}
@@ -0,0 +1,407 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "MineRings.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct BoardSize
+    {
+        int width;
+        int height;
+    };
+
+    // From the classic presets up to boards far bigger than anyone would
+    // play, where the cost of every per-tile loop shows up.
+    const BoardSize BoardSizes[] =
+    {
+        { 9, 9 },
+        { 16, 16 },
+        { 30, 16 },
+        { 256, 256 },
+        { 1024, 1024 },
+        { 4096, 4096 },
+        { 8192, 8192 },
+    };
+    // Percent of the tiles that are mines, expert is about 20.
+    const int DensityPercents[] = { 10, 20, 30 };
+
+    // Every hot path runs at least MinimumRuns times and then until it has
+    // used up MeasureTime, resets included, or has run MaximumRuns times.
+    const size_t MinimumRuns = 3;
+    const size_t MaximumRuns = 1000;
+    const auto MeasureTime = std::chrono::milliseconds(200);
+
+    // Results are summed into here so the compiler can't drop the work.
+    volatile int64_t g_sink = 0;
+
+    // Calls reset and then times body over and over. itemsPerRun is how many
+    // tiles (or calls) one run of body covers; when it's more than one the
+    // time per item is printed too.
+    template <typename Reset, typename Body>
+    void Measure(char const* hotPath, std::string const& board, uint64_t itemsPerRun, Reset&& reset, Body&& body)
+    {
+        std::vector<double> times;
+        auto measureStart = std::chrono::steady_clock::now();
+        while (times.size() < MinimumRuns ||
+            (times.size() < MaximumRuns && std::chrono::steady_clock::now() - measureStart < MeasureTime))
+        {
+            reset();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+
+        auto benchmark = std::string("micro_") + hotPath;
+        auto median = times[times.size() / 2];
+        PrintResult(benchmark.c_str(), board.c_str(), "ns_p50", median);
+        PrintResult(benchmark.c_str(), board.c_str(), "ns_min", times.front());
+        if (itemsPerRun > 1)
+        {
+            PrintResult(benchmark.c_str(), board.c_str(), "ns_per_item_p50", median / itemsPerRun);
+        }
+    }
+
+    std::string BoardName(int width, int height, char const* layout)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "%dx%d_%s", width, height, layout);
+        return name;
+    }
+
+    // Fresh, untouched games are loaded from a bitmap snapshot, which is the
+    // only way to play a layout that wasn't generated from a seed.
+    void WriteLayoutSnapshot(MineBitBoard const& mines, int numMines, std::vector<uint8_t>& snapshot)
+    {
+        auto tileCount = static_cast<size_t>(mines.Width()) * mines.Height();
+        std::vector<MineState> mineStates(tileCount, MineState::Empty);
+        std::vector<int8_t> neighborCounts(tileCount);
+        mines.ComputeNeighborCounts(neighborCounts.data());
+
+        BoardHeader header = {};
+        header.magic = BoardHeader::ExpectedMagic;
+        header.version = BoardHeader::CurrentVersion;
+        header.width = mines.Width();
+        header.height = mines.Height();
+        header.numMines = numMines;
+        header.unrevealedTiles = static_cast<int32_t>(tileCount);
+        header.mineGenerationState = MineGenerationState::Generated;
+        header.outcome = GameOutcome::Playing;
+        header.firstClickIndex = -1;
+        WriteSnapshot(header, mineStates.data(), neighborCounts.data(), SnapshotMineEncoding::Bitmap, snapshot);
+    }
+
+    void MeasureGenerateMines(int width, int height, int numMines, std::string const& board)
+    {
+        // The same steps as MinesweeperGame::GenerateMines, without the
+        // board allocation that comes with a new game.
+        auto tileCount = static_cast<size_t>(width) * height;
+        auto excludeIndex = (width / 2) * height + height / 2;
+        MineBitBoard mines;
+        std::vector<int8_t> neighborCounts(tileCount);
+        uint64_t seed = 1;
+        Measure("generate_mines", board, tileCount,
+            [&]() { mines.Reset(width, height); },
+            [&]()
+            {
+                GenerateMineLayout(seed++, numMines, excludeIndex, mines);
+                mines.ComputeNeighborCounts(neighborCounts.data());
+            });
+    }
+
+    void MeasureIndexMath(MinesweeperGame const& game, std::string const& board)
+    {
+        auto& indices = game.Indices();
+        auto tileCount = game.Width() * game.Height();
+        Measure("index_math", board, tileCount,
+            []() {},
+            [&]()
+            {
+                int64_t sum = 0;
+                for (auto index = 0; index < tileCount; index++)
+                {
+                    auto x = indices.ComputeXFromIndex(index);
+                    auto y = indices.ComputeYFromIndex(index);
+                    sum += indices.ComputeIndex(x, y) + (indices.IsInBounds(x + 1, y - 1) ? 1 : 0);
+                }
+                g_sink = g_sink + sum;
+            });
+
+        // The same round trip through a padded layout: a shift and a mask,
+        // and the border makes the neighbor always valid.
+        PaddedLayout layout(game.Width(), game.Height(), 1);
+        auto firstIndex = layout.ComputeIndex(0, 0);
+        auto lastIndex = layout.ComputeIndex(game.Width() - 1, game.Height() - 1);
+        auto diagonal = layout.NeighborOffset(1, -1);
+        Measure("padded_index_math", board, tileCount,
+            []() {},
+            [&]()
+            {
+                int64_t sum = 0;
+                for (auto index = firstIndex; index <= lastIndex; index++)
+                {
+                    auto x = layout.ComputeXFromIndex(index);
+                    auto y = layout.ComputeYFromIndex(index);
+                    sum += layout.ComputeIndex(x, y) + index + diagonal;
+                }
+                g_sink = g_sink + sum;
+            });
+    }
+
+    // Times every hot path that depends on where the mines are on one layout.
+    void MeasureLayout(MineBitBoard const& mines, int numMines, std::string const& board)
+    {
+        auto width = mines.Width();
+        auto height = mines.Height();
+        auto tileCount = width * height;
+
+        std::vector<uint8_t> snapshot;
+        WriteLayoutSnapshot(mines, numMines, snapshot);
+        MinesweeperGame game;
+        auto reload = [&]() { game.LoadSnapshot(snapshot.data(), snapshot.size()); };
+        reload();
+
+        int64_t checkedCount = 0;
+        Measure("surrounding_mine_count", board, tileCount,
+            []() {},
+            [&]()
+            {
+                int64_t sum = 0;
+                for (auto x = 0; x < width; x++)
+                {
+                    for (auto y = 0; y < height; y++)
+                    {
+                        sum += game.GetSurroundingMineCount(x, y);
+                    }
+                }
+                checkedCount = sum;
+                g_sink = g_sink + sum;
+            });
+
+        // The same counts from a padded copy of the mines, where every tile
+        // adds up its eight neighbors at fixed offsets with no bounds checks.
+        PaddedLayout layout(width, height, 1);
+        std::vector<uint8_t> paddedMines(layout.TileCount(), 0);
+        for (auto x = 0; x < width; x++)
+        {
+            for (auto y = 0; y < height; y++)
+            {
+                paddedMines[layout.ComputeIndex(x, y)] = mines.Test(x, y) ? 1 : 0;
+            }
+        }
+        int offsets[8];
+        auto offsetCount = 0;
+        for (auto offsetX = -1; offsetX <= 1; offsetX++)
+        {
+            for (auto offsetY = -1; offsetY <= 1; offsetY++)
+            {
+                if (offsetX != 0 || offsetY != 0)
+                {
+                    offsets[offsetCount++] = layout.NeighborOffset(offsetX, offsetY);
+                }
+            }
+        }
+        int64_t paddedCount = 0;
+        Measure("padded_mine_count", board, tileCount,
+            []() {},
+            [&]()
+            {
+                int64_t sum = 0;
+                auto data = paddedMines.data();
+                for (auto x = 0; x < width; x++)
+                {
+                    auto column = data + layout.ComputeIndex(x, 0);
+                    for (auto y = 0; y < height; y++)
+                    {
+                        auto tile = column + y;
+                        sum += tile[offsets[0]] + tile[offsets[1]] + tile[offsets[2]] + tile[offsets[3]] +
+                            tile[offsets[4]] + tile[offsets[5]] + tile[offsets[6]] + tile[offsets[7]];
+                    }
+                }
+                paddedCount = sum;
+                g_sink = g_sink + sum;
+            });
+        PrintResult("micro_padded_mine_count", board.c_str(), "same_counts", paddedCount == checkedCount ? 1.0 : 0.0);
+
+        const int CheckIfWonCalls = 1 << 16;
+        Measure("check_if_won", board, CheckIfWonCalls,
+            []() {},
+            [&]()
+            {
+                int64_t won = 0;
+                for (auto i = 0; i < CheckIfWonCalls; i++)
+                {
+                    won += game.CheckIfWon() ? 1 : 0;
+                }
+                g_sink = g_sink + won;
+            });
+
+        // Numbered tiles reveal just themselves. Each run presses the next
+        // one, and the board is only reloaded once they've all been pressed.
+        auto counts = game.NeighborCounts();
+        std::vector<int> numberedTiles;
+        auto zeroTile = -1;
+        auto mineTile = -1;
+        for (auto i = 0; i < tileCount && (numberedTiles.size() < MaximumRuns || zeroTile < 0 || mineTile < 0); i++)
+        {
+            // Start from the middle, so the opening isn't always in a corner.
+            auto index = (i + tileCount / 2) % tileCount;
+            if (counts[index] > 0 && numberedTiles.size() < MaximumRuns)
+            {
+                numberedTiles.push_back(index);
+            }
+            else if (counts[index] == 0 && zeroTile < 0)
+            {
+                zeroTile = index;
+            }
+            else if (counts[index] < 0 && mineTile < 0)
+            {
+                mineTile = index;
+            }
+        }
+
+        // Reloading replaces the game's IndexHelper, so it's looked up each time.
+        auto press = [&](int index)
+        {
+            auto& indices = game.Indices();
+            g_sink = g_sink + static_cast<int>(game.Press(indices.ComputeXFromIndex(index), indices.ComputeYFromIndex(index), false));
+        };
+        if (!numberedTiles.empty())
+        {
+            size_t next = numberedTiles.size();
+            Measure("sweep_number", board, 1,
+                [&]()
+                {
+                    if (next == numberedTiles.size() || game.IsGameOver())
+                    {
+                        reload();
+                        next = 0;
+                    }
+                },
+                [&]() { press(numberedTiles[next++]); });
+        }
+        if (zeroTile >= 0)
+        {
+            Measure("sweep_opening", board, 1, reload, [&]() { press(zeroTile); });
+            uint64_t revealed = 0;
+            for (auto& span : game.RevealedSpans())
+            {
+                revealed += span.length;
+            }
+            PrintResult("micro_sweep_opening", board.c_str(), "tiles_revealed", static_cast<double>(revealed));
+
+            // The same sweep with a UI attached, recorded instead of drawn.
+            TileUpdateRecorder recorder;
+            game.SetTileUpdateSink(&recorder);
+            Measure("sweep_opening_batched", board, 1,
+                [&]()
+                {
+                    reload();
+                    recorder.Clear();
+                },
+                [&]() { press(zeroTile); });
+            game.SetTileUpdateSink(nullptr);
+            PrintResult("micro_sweep_opening_batched", board.c_str(), "batches", static_cast<double>(recorder.BatchEnds().size()));
+            PrintResult("micro_sweep_opening_batched", board.c_str(), "tile_updates", static_cast<double>(recorder.Updates().size()));
+        }
+
+        // Snapshots of the board as it is now, with the opening revealed if
+        // there was one. Saving packs the tile states and the mines, loading
+        // unpacks both.
+        std::vector<uint8_t> saved;
+        Measure("save_snapshot", board, tileCount,
+            []() {},
+            [&]() { WriteSnapshot(game.Header(), game.MineStates(), game.NeighborCounts(), SnapshotMineEncoding::Bitmap, saved); });
+        Measure("load_snapshot", board, tileCount,
+            []() {},
+            [&]() { game.LoadSnapshot(saved.data(), saved.size()); });
+
+        if (mineTile >= 0)
+        {
+            Measure("sweep_mine", board, 1, reload, [&]() { press(mineTile); });
+
+            // The animation starts at the mine that was hit.
+            auto mineX = game.Indices().ComputeXFromIndex(mineTile);
+            auto mineY = game.Indices().ComputeYFromIndex(mineTile);
+            MineRings rings;
+            Measure("mine_rings", board, tileCount,
+                []() {},
+                [&]() { game.ComputeMineRings(mineX, mineY, rings); });
+        }
+    }
+
+    void MeasureSize(BoardSize const& size)
+    {
+        auto width = size.width;
+        auto height = size.height;
+        auto tileCount = width * height;
+        auto centerIndex = (width / 2) * height + height / 2;
+        MineBitBoard mines;
+
+        {
+            MinesweeperGame game;
+            game.NewGame(width, height, 1, 1);
+            MeasureIndexMath(game, BoardName(width, height, "any"));
+        }
+
+        for (auto percent : DensityPercents)
+        {
+            auto numMines = std::max(1, tileCount / 100 * percent + tileCount % 100 * percent / 100);
+            auto board = BoardName(width, height, std::to_string(percent).c_str());
+            MeasureGenerateMines(width, height, numMines, board);
+
+            mines.Reset(width, height);
+            GenerateMineLayout(1, numMines, centerIndex, mines);
+            MeasureLayout(mines, numMines, board);
+        }
+
+        // One mine in the corner, so the first sweep anywhere else opens
+        // the whole board.
+        mines.Reset(width, height);
+        mines.Set(0, 0);
+        MeasureLayout(mines, 1, BoardName(width, height, "opening"));
+
+        // Every tile but the center is a mine.
+        auto board = BoardName(width, height, "maxdensity");
+        MeasureGenerateMines(width, height, tileCount - 1, board);
+        mines.Reset(width, height);
+        GenerateMineLayout(1, tileCount - 1, centerIndex, mines);
+        MeasureLayout(mines, tileCount - 1, board);
+
+        // Every other tile is a mine, so there are no openings and every
+        // ring is half mines.
+        mines.Reset(width, height);
+        auto checkerMines = 0;
+        for (auto x = 0; x < width; x++)
+        {
+            for (auto y = (x % 2); y < height; y += 2)
+            {
+                mines.Set(x, y);
+                checkerMines++;
+            }
+        }
+        MeasureLayout(mines, checkerMines, BoardName(width, height, "checkerboard"));
+    }
+}
+
+void RunMicroBenchmark(int maximumSide)
+{
+    for (auto& size : BoardSizes)
+    {
+        if (size.width <= maximumSide && size.height <= maximumSide)
+        {
+            MeasureSize(size);
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    const int RandomBoards = 2000;
+
+    // Heights around every word boundary, on top of the random ones.
+    const int EdgeHeights[] = { 1, 2, 3, 63, 64, 65, 127, 128, 129, 191, 193 };
+
+    // Loads the layout into a game the way a saved game would be. The bitmap
+    // is written from isMine, not from anything the bit board computed, so
+    // the game's counts come from nothing but MineBitBoard::ComputeNeighborCounts.
+    void LoadLayout(MinesweeperGame& game, int width, int height, std::vector<int8_t> const& isMine, int numMines, std::vector<uint8_t>& snapshot)
+    {
+        auto tileCount = static_cast<size_t>(width) * height;
+        std::vector<MineState> mineStates(tileCount, MineState::Empty);
+
+        BoardHeader header = {};
+        header.magic = BoardHeader::ExpectedMagic;
+        header.version = BoardHeader::CurrentVersion;
+        header.width = width;
+        header.height = height;
+        header.numMines = numMines;
+        header.unrevealedTiles = static_cast<int32_t>(tileCount);
+        header.mineGenerationState = MineGenerationState::Generated;
+        header.outcome = GameOutcome::Playing;
+        header.firstClickIndex = -1;
+        WriteSnapshot(header, mineStates.data(), isMine.data(), SnapshotMineEncoding::Bitmap, snapshot);
+        game.LoadSnapshot(snapshot.data(), snapshot.size());
+    }
+
+    // Counts the mines around a tile straight from isMine.
+    int CountAround(std::vector<int8_t> const& isMine, int width, int height, int x, int y)
+    {
+        auto count = 0;
+        for (auto neighborX = std::max(x - 1, 0); neighborX <= std::min(x + 1, width - 1); neighborX++)
+        {
+            for (auto neighborY = std::max(y - 1, 0); neighborY <= std::min(y + 1, height - 1); neighborY++)
+            {
+                count += isMine[neighborX * height + neighborY] ? 1 : 0;
+            }
+        }
+        return count - (isMine[x * height + y] ? 1 : 0);
+    }
+
+    // Returns how many tiles disagree between the scalar path, the AVX2 path
+    // (when this CPU has it), the game's counts and a count straight from the
+    // layout. A game always leaves a tile free, so boards that are all mines
+    // only check the bit board.
+    uint64_t CheckBoard(MinesweeperGame& game, int width, int height, int densityPercent, RandomGenerator& random, std::vector<uint8_t>& snapshot)
+    {
+        auto tileCount = static_cast<size_t>(width) * height;
+        MineBitBoard mines(width, height);
+        // -1 for a mine, like a neighbor count, so it can stand in for counts
+        // when writing the snapshot.
+        std::vector<int8_t> isMine(tileCount, 0);
+        auto numMines = 0;
+        for (auto x = 0; x < width; x++)
+        {
+            for (auto y = 0; y < height; y++)
+            {
+                if (static_cast<int>(random.NextBelow(100)) < densityPercent)
+                {
+                    mines.Set(x, y);
+                    isMine[x * height + y] = -1;
+                    numMines++;
+                }
+            }
+        }
+
+        std::vector<int8_t> scalarCounts(tileCount);
+        std::vector<int8_t> counts(tileCount);
+        mines.ComputeNeighborCounts(scalarCounts.data(), false);
+        mines.ComputeNeighborCounts(counts.data());
+        auto loaded = static_cast<size_t>(numMines) < tileCount;
+        if (loaded)
+        {
+            LoadLayout(game, width, height, isMine, numMines, snapshot);
+        }
+
+        uint64_t mismatches = 0;
+        auto gameCounts = game.NeighborCounts();
+        for (auto x = 0; x < width; x++)
+        {
+            for (auto y = 0; y < height; y++)
+            {
+                auto index = x * height + y;
+                if (loaded && game.IsMine(index) != (isMine[index] != 0))
+                {
+                    mismatches++;
+                    continue;
+                }
+
+                auto expected = isMine[index] ? -1 : CountAround(isMine, width, height, x, y);
+                if (scalarCounts[index] != expected || counts[index] != expected || (loaded && gameCounts[index] != expected))
+                {
+                    mismatches++;
+                }
+            }
+        }
+        return mismatches;
+    }
+}
+
+bool RunNeighborCountCheck()
+{
+    MinesweeperGame game;
+    // Boards the size of a preset would take the preset kernels instead.
+    game.SetUsePresetBoards(false);
+    std::vector<uint8_t> snapshot;
+    RandomGenerator random(1);
+    uint64_t boards = 0;
+    uint64_t mismatches = 0;
+
+    // Every density, including none and all, on the edge heights and widths
+    // that do and don't fill whole groups of four columns.
+    for (auto height : EdgeHeights)
+    {
+        for (auto width = 1; width <= 9; width++)
+        {
+            for (auto density : { 0, 15, 50, 85, 100 })
+            {
+                mismatches += CheckBoard(game, width, height, density, random, snapshot);
+                boards++;
+            }
+        }
+    }
+
+    for (auto i = 0; i < RandomBoards; i++)
+    {
+        auto width = 1 + static_cast<int>(random.NextBelow(70));
+        // Mostly odd heights, rarely a multiple of 64.
+        auto height = 1 + 2 * static_cast<int>(random.NextBelow(150));
+        auto density = static_cast<int>(random.NextBelow(101));
+        mismatches += CheckBoard(game, width, height, density, random, snapshot);
+        boards++;
+    }
+
+#if MSWEEP_AVX2_AVAILABLE
+    auto avx2 = IsAvx2Supported();
+#else
+    auto avx2 = false;
+#endif
+    PrintResult("check", "neighbor_counts", "boards", static_cast<double>(boards));
+    PrintResult("check", "neighbor_counts", "avx2_checked", avx2 ? 1.0 : 0.0);
+    PrintResult("check", "neighbor_counts", "mismatches", static_cast<double>(mismatches));
+    return mismatches == 0;
+}
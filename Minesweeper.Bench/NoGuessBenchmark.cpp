@@ -0,0 +1,52 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "SpanFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    const int BoardsPerPreset = 32;
+}
+
+void RunNoGuessBenchmark()
+{
+    NoGuessGenerator generator;
+
+    for (auto& preset : ClassicPresets)
+    {
+        // The first click is always in the middle, like the other benchmarks.
+        auto firstClickIndex = (preset.width / 2) * preset.height + preset.height / 2;
+
+        std::vector<double> times;
+        uint64_t attempts = 0;
+        auto failures = 0;
+        auto timeouts = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t seed = 1; seed <= BoardsPerPreset; seed++)
+        {
+            auto boardStart = std::chrono::steady_clock::now();
+            if (!generator.FindSeed(preset.width, preset.height, preset.mines, firstClickIndex, seed))
+            {
+                failures++;
+                timeouts += generator.TimedOut() ? 1 : 0;
+            }
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - boardStart).count());
+            attempts += generator.Attempts();
+        }
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::sort(times.begin(), times.end());
+
+        auto boardsPerSecond = BoardsPerPreset / seconds;
+        PrintResult("noguess", preset.name, "boards_per_sec", boardsPerSecond);
+        PrintResult("noguess", preset.name, "boards_per_sec_per_core", boardsPerSecond / generator.ThreadCount());
+        PrintResult("noguess", preset.name, "attempts_per_board", static_cast<double>(attempts) / BoardsPerPreset);
+        PrintResult("noguess", preset.name, "ms_per_board_p50", times[times.size() / 2]);
+        PrintResult("noguess", preset.name, "ms_per_board_max", times.back());
+        PrintResult("noguess", preset.name, "failures", failures);
+        PrintResult("noguess", preset.name, "timeouts", timeouts);
+    }
+    PrintResult("noguess", "all", "threads", generator.ThreadCount());
+}
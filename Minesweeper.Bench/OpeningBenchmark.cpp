@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    // Openings from a handful of tiles up to far more than any board a
+    // person would play.
+    const int OpeningSizes[] = { 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+
+    // Every fill runs at least MinimumRuns times and then until it has used
+    // up MeasureTime, resets included, or has run MaximumRuns times.
+    const size_t MinimumRuns = 3;
+    const size_t MaximumRuns = 1000;
+    const auto MeasureTime = std::chrono::milliseconds(500);
+
+    // Smaller openings are over before another thread could be woken.
+    const int ParallelMinimumTiles = 100000;
+
+    volatile int64_t g_sink = 0;
+
+    // An opening of openingWidth by openingHeight tiles with no mines in it,
+    // walled in by a ring of mines on the board's edge. Pressing any tile
+    // that isn't next to the wall reveals exactly the opening: its inside is
+    // zeros and its edge is the numbered border.
+    struct OpeningBoard
+    {
+        int openingWidth;
+        int openingHeight;
+        int width;
+        int height;
+        int numMines;
+        std::vector<int8_t> neighborCounts;
+        std::vector<uint8_t> snapshot;
+
+        OpeningBoard(int openingTiles)
+        {
+            // As square as it can be, and at least 3x3 so the middle is a zero.
+            openingHeight = std::max(3, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(openingTiles)))));
+            openingWidth = std::max(3, (openingTiles + openingHeight - 1) / openingHeight);
+            width = openingWidth + 2;
+            height = openingHeight + 2;
+
+            MineBitBoard mines(width, height);
+            numMines = 0;
+            for (auto x = 0; x < width; x++)
+            {
+                for (auto y = 0; y < height; y++)
+                {
+                    if (x == 0 || y == 0 || x == width - 1 || y == height - 1)
+                    {
+                        mines.Set(x, y);
+                        numMines++;
+                    }
+                }
+            }
+
+            auto tileCount = static_cast<size_t>(width) * height;
+            neighborCounts.resize(tileCount);
+            mines.ComputeNeighborCounts(neighborCounts.data());
+
+            std::vector<MineState> mineStates(tileCount, MineState::Empty);
+            BoardHeader header = {};
+            header.magic = BoardHeader::ExpectedMagic;
+            header.version = BoardHeader::CurrentVersion;
+            header.width = width;
+            header.height = height;
+            header.numMines = numMines;
+            header.unrevealedTiles = static_cast<int32_t>(tileCount);
+            header.mineGenerationState = MineGenerationState::Generated;
+            header.outcome = GameOutcome::Playing;
+            header.firstClickIndex = -1;
+            WriteSnapshot(header, mineStates.data(), neighborCounts.data(), SnapshotMineEncoding::Bitmap, snapshot);
+        }
+
+        int OpeningTiles() const { return openingWidth * openingHeight; }
+        int PressX() const { return width / 2; }
+        int PressY() const { return height / 2; }
+    };
+
+    // Calls reset and then times body over and over, and prints the median
+    // run along with how many revealed tiles a second that is. A threadCount
+    // above 0 is added to the board's name.
+    template <typename Reset, typename Body>
+    void MeasureOpening(char const* path, OpeningBoard const& board, int threadCount, Reset&& reset, Body&& body)
+    {
+        std::vector<double> times;
+        auto measureStart = std::chrono::steady_clock::now();
+        while (times.size() < MinimumRuns ||
+            (times.size() < MaximumRuns && std::chrono::steady_clock::now() - measureStart < MeasureTime))
+        {
+            reset();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+
+        char name[64];
+        if (threadCount > 0)
+        {
+            snprintf(name, sizeof(name), "%dx%d_%dt", board.width, board.height, threadCount);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "%dx%d", board.width, board.height);
+        }
+        auto median = times[times.size() / 2];
+        PrintResult(path, name, "tiles", static_cast<double>(board.OpeningTiles()));
+        PrintResult(path, name, "ns_p50", median);
+        PrintResult(path, name, "tiles_per_sec", board.OpeningTiles() / (median / 1e9));
+    }
+
+    // Complains if a fill didn't reveal exactly the opening.
+    void CheckRevealed(char const* path, OpeningBoard const& board, std::vector<TileSpan> const& revealedSpans)
+    {
+        int64_t revealed = 0;
+        for (auto& span : revealedSpans)
+        {
+            revealed += span.length;
+        }
+        if (revealed != board.OpeningTiles())
+        {
+            fprintf(stderr, "%s revealed %lld of %d tiles\n", path, static_cast<long long>(revealed), board.OpeningTiles());
+        }
+        g_sink = g_sink + revealed;
+    }
+}
+
+void RunOpeningBenchmark(int maximumThreads)
+{
+    if (maximumThreads <= 0)
+    {
+        maximumThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Doubling up to the maximum, and the maximum itself.
+    std::vector<int> threadCounts;
+    for (auto threadCount = 1; threadCount < maximumThreads; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maximumThreads);
+
+    for (auto openingTiles : OpeningSizes)
+    {
+        OpeningBoard board(openingTiles);
+        auto tileCount = static_cast<size_t>(board.width) * board.height;
+
+        // The fill by itself, on the board's own arrays.
+        {
+            std::vector<MineState> mineStates(tileCount);
+            std::vector<TileSpan> revealedSpans;
+            SpanFloodFill floodFill;
+            MeasureOpening("opening_span_fill", board, 0,
+                [&]()
+                {
+                    std::fill(mineStates.begin(), mineStates.end(), MineState::Empty);
+                    revealedSpans.clear();
+                },
+                [&]()
+                {
+                    floodFill.Fill(mineStates.data(), board.neighborCounts.data(), board.width, board.height, board.PressX(), board.PressY(), revealedSpans);
+                });
+            CheckRevealed("opening_span_fill", board, revealedSpans);
+        }
+
+        // How the parallel fill scales from one thread up.
+        if (openingTiles >= ParallelMinimumTiles)
+        {
+            for (auto threadCount : threadCounts)
+            {
+                std::vector<MineState> mineStates(tileCount);
+                std::vector<TileSpan> revealedSpans;
+                ParallelFloodFill floodFill(threadCount);
+                MeasureOpening("opening_parallel_fill", board, threadCount,
+                    [&]()
+                    {
+                        std::fill(mineStates.begin(), mineStates.end(), MineState::Empty);
+                        revealedSpans.clear();
+                    },
+                    [&]()
+                    {
+                        floodFill.Fill(mineStates.data(), board.neighborCounts.data(), board.width, board.height, board.PressX(), board.PressY(), revealedSpans);
+                    });
+                CheckRevealed("opening_parallel_fill", board, revealedSpans);
+            }
+        }
+
+        // The same opening through a press, which is what a click costs.
+        {
+            MinesweeperGame game;
+            game.SetUsePresetBoards(false);
+            MeasureOpening("opening_press", board, 0,
+                [&]() { game.LoadSnapshot(board.snapshot.data(), board.snapshot.size()); },
+                [&]() { g_sink = g_sink + static_cast<int>(game.Press(board.PressX(), board.PressY(), false)); });
+        }
+    }
+}
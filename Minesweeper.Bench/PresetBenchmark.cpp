@@ -0,0 +1,97 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    const uint64_t GamesPerPreset = 20000;
+
+    struct PresetRun
+    {
+        double newGameMicroseconds = 0.0;
+        double playMicroseconds = 0.0;
+        std::vector<uint64_t> hashes;
+    };
+
+    // Plays every game to a win, sweeping the tiles that aren't mines in
+    // sweepOrder. Only the presses are timed, the first one (which places the
+    // mines) apart from the rest.
+    void PlayGames(MinesweeperGame& game, BoardPreset const& preset, std::vector<int> const& sweepOrder, PresetRun& run)
+    {
+        run.hashes.clear();
+        std::chrono::steady_clock::duration newGameTime{ 0 };
+        std::chrono::steady_clock::duration playTime{ 0 };
+        for (uint64_t seed = 1; seed <= GamesPerPreset; seed++)
+        {
+            game.NewGame(preset.width, preset.height, preset.mines, seed);
+            auto start = std::chrono::steady_clock::now();
+            game.Press(preset.width / 2, preset.height / 2, false);
+            auto firstPressDone = std::chrono::steady_clock::now();
+            newGameTime += firstPressDone - start;
+
+            for (auto index : sweepOrder)
+            {
+                if (game.IsGameOver())
+                {
+                    break;
+                }
+                if (game.MineStates()[index] == MineState::Empty && !game.IsMine(index))
+                {
+                    game.Press(index / preset.height, index % preset.height, false);
+                }
+            }
+            playTime += std::chrono::steady_clock::now() - firstPressDone;
+            run.hashes.push_back(game.ComputeStateHash());
+        }
+        run.newGameMicroseconds = std::chrono::duration<double, std::micro>(newGameTime).count();
+        run.playMicroseconds = std::chrono::duration<double, std::micro>(playTime).count();
+    }
+}
+
+void RunPresetBenchmark()
+{
+    MinesweeperGame game;
+    PresetRun generic;
+    PresetRun preset;
+    std::vector<int> sweepOrder;
+    for (auto& board : ClassicPresets)
+    {
+        // The same order for every game, so that making it isn't timed.
+        RandomGenerator random(7);
+        auto tileCount = board.width * board.height;
+        sweepOrder.resize(tileCount);
+        for (auto i = 0; i < tileCount; i++)
+        {
+            sweepOrder[i] = i;
+        }
+        for (auto i = tileCount - 1; i > 0; i--)
+        {
+            std::swap(sweepOrder[i], sweepOrder[random.NextBelow(i + 1)]);
+        }
+
+        game.SetUsePresetBoards(false);
+        PlayGames(game, board, sweepOrder, generic);
+        game.SetUsePresetBoards(true);
+        PlayGames(game, board, sweepOrder, preset);
+
+        auto games = static_cast<double>(GamesPerPreset);
+        PrintResult("preset", board.name, "first_press_ns_generic", generic.newGameMicroseconds * 1000.0 / games);
+        PrintResult("preset", board.name, "first_press_ns_preset", preset.newGameMicroseconds * 1000.0 / games);
+        PrintResult("preset", board.name, "first_press_speedup", generic.newGameMicroseconds / preset.newGameMicroseconds);
+        PrintResult("preset", board.name, "game_us_generic", generic.playMicroseconds / games);
+        PrintResult("preset", board.name, "game_us_preset", preset.playMicroseconds / games);
+        PrintResult("preset", board.name, "game_speedup", generic.playMicroseconds / preset.playMicroseconds);
+        PrintResult("preset", board.name, "same_result", generic.hashes == preset.hashes ? 1.0 : 0.0);
+    }
+}
@@ -0,0 +1,100 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "ProbabilitySolver.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct StuckBoard
+    {
+        std::vector<MineState> mineStates;
+        std::vector<int8_t> neighborCounts;
+    };
+
+    const int BoardsPerPreset = 64;
+    const int RunsPerBoard = 8;
+
+    // Plays a seeded game with the solver and keeps the board it gets stuck
+    // on, which is exactly when probabilities are needed.
+    bool FindStuckBoard(BoardPreset const& preset, uint64_t seed, MineSolver& solver, StuckBoard& board)
+    {
+        MinesweeperGame game;
+        game.NewGame(preset.width, preset.height, preset.mines, seed);
+        game.Press(preset.width / 2, preset.height / 2, false);
+
+        std::vector<int> safeTiles;
+        std::vector<int> mineTiles;
+        while (!game.IsGameOver())
+        {
+            safeTiles.clear();
+            mineTiles.clear();
+            solver.Solve(preset.width, preset.height, game.MineStates(), game.NeighborCounts(), false, safeTiles, mineTiles);
+            if (safeTiles.empty())
+            {
+                auto tileCount = static_cast<size_t>(preset.width) * preset.height;
+                board.mineStates.assign(game.MineStates(), game.MineStates() + tileCount);
+                board.neighborCounts.assign(game.NeighborCounts(), game.NeighborCounts() + tileCount);
+                return true;
+            }
+            for (auto index : safeTiles)
+            {
+                game.Press(game.Indices().ComputeXFromIndex(index), game.Indices().ComputeYFromIndex(index), false);
+            }
+        }
+        return false;
+    }
+}
+
+void RunProbabilityBenchmark()
+{
+    MineSolver solver;
+    ProbabilitySolver probabilities;
+    std::vector<double> result;
+
+    for (auto& preset : ClassicPresets)
+    {
+        std::vector<StuckBoard> boards;
+        StuckBoard board;
+        for (uint64_t seed = 1; boards.size() < BoardsPerPreset; seed++)
+        {
+            if (FindStuckBoard(preset, seed, solver, board))
+            {
+                boards.push_back(board);
+            }
+        }
+
+        // A frame is about 16ms, so the slowest board matters as much as the
+        // typical one.
+        std::vector<double> times;
+        size_t estimated = 0;
+        for (auto& stuck : boards)
+        {
+            for (auto run = 0; run < RunsPerBoard; run++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                probabilities.Compute(preset.width, preset.height, stuck.mineStates.data(), stuck.neighborCounts.data(), preset.mines, false, result);
+                times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+            if (probabilities.UsedEstimate())
+            {
+                estimated++;
+            }
+        }
+        std::sort(times.begin(), times.end());
+
+        PrintResult("probability", preset.name, "ms_per_board_p50", times[times.size() / 2]);
+        PrintResult("probability", preset.name, "ms_per_board_max", times.back());
+        PrintResult("probability", preset.name, "estimated_fraction", static_cast<double>(estimated) / boards.size());
+    }
+    PrintResult("probability", "all", "threads", probabilities.ThreadCount());
+}
@@ -0,0 +1,410 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "TilePacking.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct RecordBoard
+    {
+        char const* name;
+        int width;
+        int height;
+    };
+
+    // One board that fits in a typical L2 with room to spare as two arrays,
+    // and one that doesn't fit in most L3s either way.
+    const RecordBoard RecordBoards[] =
+    {
+        { "1024x1024", 1024, 1024 },
+        { "4096x4096", 4096, 4096 },
+    };
+
+    // The same density as the layout benchmark, so a sweep from the middle
+    // opens most of the board.
+    const int MinePercent = 5;
+    const int TimedRuns = 5;
+    const int PressCount = 1 << 20;
+
+    // The game's own storage, the two byte arrays BoardStorage keeps.
+    struct SplitTiles
+    {
+        static constexpr char const* Name = "split";
+
+        std::vector<MineState> states;
+        std::vector<int8_t> counts;
+
+        size_t BytesPerTile() const { return sizeof(MineState) + sizeof(int8_t); }
+
+        void Cover() { std::fill(states.begin(), states.end(), MineState::Empty); }
+        bool IsCovered(size_t index) const { return states[index] == MineState::Empty; }
+        bool IsUnmarkedZero(size_t index) const { return states[index] == MineState::Empty && counts[index] == 0; }
+        int8_t Count(size_t index) const { return counts[index]; }
+        void Reveal(size_t index) { states[index] = MineState::Revealed; }
+        void RevealRun(size_t first, size_t last) { std::fill(states.begin() + first, states.begin() + last + 1, MineState::Revealed); }
+
+        // The game's path: the bit board's counts go straight into place,
+        // and the states are left alone.
+        void GenerateCounts(MineBitBoard const& mines, size_t tileCount)
+        {
+            states.resize(tileCount, MineState::Empty);
+            counts.resize(tileCount);
+            mines.ComputeNeighborCounts(counts.data());
+        }
+
+        void Pack(uint8_t* packedStates, uint8_t* packedMines, size_t tileCount) const
+        {
+            PackTileStates(states.data(), tileCount, packedStates);
+            PackMines(counts.data(), tileCount, packedMines);
+        }
+    };
+
+    // The record the request asked for: the state in the low two bits, the
+    // count in the four above them and the mine bit on top, where a sign
+    // test or movemask finds it. An unmarked zero is the only record that
+    // is all zeroes.
+    struct PackedTiles
+    {
+        static constexpr char const* Name = "packed";
+        static const uint8_t StateMask = 0x03;
+        static const int CountShift = 2;
+        static const uint8_t CountMask = 0x3c;
+        static const uint8_t MineBit = 0x80;
+
+        std::vector<uint8_t> records;
+        std::vector<int8_t> scratch;
+
+        size_t BytesPerTile() const { return sizeof(uint8_t); }
+
+        void Cover()
+        {
+            for (auto& record : records)
+            {
+                record &= static_cast<uint8_t>(~StateMask);
+            }
+        }
+        bool IsCovered(size_t index) const { return (records[index] & StateMask) == static_cast<uint8_t>(MineState::Empty); }
+        bool IsUnmarkedZero(size_t index) const { return records[index] == 0; }
+        int8_t Count(size_t index) const
+        {
+            auto record = records[index];
+            return (record & MineBit) ? -1 : static_cast<int8_t>((record & CountMask) >> CountShift);
+        }
+        void Reveal(size_t index) { records[index] |= static_cast<uint8_t>(MineState::Revealed); }
+        void RevealRun(size_t first, size_t last)
+        {
+            for (auto index = first; index <= last; index++)
+            {
+                records[index] |= static_cast<uint8_t>(MineState::Revealed);
+            }
+        }
+
+        // The bit board's kernels write one count a byte, so the records
+        // are folded together from those afterwards.
+        void GenerateCounts(MineBitBoard const& mines, size_t tileCount)
+        {
+            scratch.resize(tileCount);
+            records.resize(tileCount);
+            mines.ComputeNeighborCounts(scratch.data());
+            for (size_t index = 0; index < tileCount; index++)
+            {
+                auto count = scratch[index];
+                records[index] = count < 0 ? MineBit : static_cast<uint8_t>(count << CountShift);
+            }
+        }
+
+        void Pack(uint8_t* packedStates, uint8_t* packedMines, size_t tileCount) const
+        {
+            size_t done = 0;
+#if MSWEEP_AVX2_AVAILABLE
+            if (IsAvx2Supported())
+            {
+                done = PackAvx2(records.data(), tileCount, packedStates, packedMines);
+            }
+#endif
+            for (auto index = done; index < tileCount; index++)
+            {
+                if (index % 4 == 0)
+                {
+                    packedStates[index / 4] = 0;
+                }
+                if (index % 8 == 0)
+                {
+                    packedMines[index / 8] = 0;
+                }
+                packedStates[index / 4] |= static_cast<uint8_t>((records[index] & StateMask) << ((index % 4) * 2));
+                packedMines[index / 8] |= static_cast<uint8_t>(((records[index] & MineBit) ? 1 : 0) << (index % 8));
+            }
+        }
+
+#if MSWEEP_AVX2_AVAILABLE
+        // PackTileStates and PackMines in one pass, with the state masked
+        // out of each record first.
+        static MSWEEP_AVX2_TARGET size_t PackAvx2(uint8_t const* records, size_t tileCount, uint8_t* packedStates, uint8_t* packedMines)
+        {
+            auto stateMask = _mm256_set1_epi8(StateMask);
+            auto pairWeights = _mm256_set1_epi16(0x0401);
+            auto quadWeights = _mm256_set1_epi32(0x00100001);
+            auto lowBytes = _mm256_setr_epi8(
+                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+            auto bothLanes = _mm256_setr_epi32(0, 4, 1, 2, 3, 5, 6, 7);
+
+            size_t i = 0;
+            for (; i + 32 <= tileCount; i += 32)
+            {
+                auto tiles = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(records + i));
+                auto mines = static_cast<uint32_t>(_mm256_movemask_epi8(tiles));
+                memcpy(packedMines + i / 8, &mines, sizeof(mines));
+
+                auto states = _mm256_and_si256(tiles, stateMask);
+                auto pairs = _mm256_maddubs_epi16(states, pairWeights);
+                auto quads = _mm256_madd_epi16(pairs, quadWeights);
+                auto gathered = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(quads, lowBytes), bothLanes);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(packedStates + i / 4), _mm256_castsi256_si128(gathered));
+            }
+            return i;
+        }
+#endif
+    };
+
+    // SpanFloodFill::Fill over either storage, so both pay for the same
+    // algorithm and only the tile accesses differ.
+    template <typename Tiles>
+    uint64_t Sweep(Tiles& tiles, int width, int height, int startX, int startY, std::vector<std::pair<int, int>>& seeds)
+    {
+        uint64_t revealed = 0;
+        auto scanColumn = [&](int x, int firstY, int lastY)
+        {
+            auto column = static_cast<size_t>(x) * height;
+            auto y = firstY;
+            while (y <= lastY)
+            {
+                if (!tiles.IsCovered(column + y))
+                {
+                    y++;
+                }
+                else if (tiles.Count(column + y) == 0)
+                {
+                    seeds.push_back({ x, y });
+                    while (y <= lastY && tiles.IsUnmarkedZero(column + y))
+                    {
+                        y++;
+                    }
+                }
+                else
+                {
+                    while (y <= lastY && tiles.IsCovered(column + y) && tiles.Count(column + y) != 0)
+                    {
+                        tiles.Reveal(column + y);
+                        revealed++;
+                        y++;
+                    }
+                }
+            }
+        };
+
+        seeds.clear();
+        seeds.push_back({ startX, startY });
+        while (!seeds.empty())
+        {
+            auto seed = seeds.back();
+            seeds.pop_back();
+
+            auto column = static_cast<size_t>(seed.first) * height;
+            if (!tiles.IsCovered(column + seed.second))
+            {
+                continue;
+            }
+
+            auto firstZero = seed.second;
+            while (firstZero > 0 && tiles.IsUnmarkedZero(column + firstZero - 1))
+            {
+                firstZero--;
+            }
+            auto lastZero = seed.second;
+            while (lastZero < height - 1 && tiles.IsUnmarkedZero(column + lastZero + 1))
+            {
+                lastZero++;
+            }
+
+            auto first = firstZero;
+            if (first > 0 && tiles.IsCovered(column + first - 1))
+            {
+                first--;
+            }
+            auto last = lastZero;
+            if (last < height - 1 && tiles.IsCovered(column + last + 1))
+            {
+                last++;
+            }
+            tiles.RevealRun(column + first, column + last);
+            revealed += last - first + 1;
+
+            auto neighborFirst = std::max(0, firstZero - 1);
+            auto neighborLast = std::min(height - 1, lastZero + 1);
+            for (auto neighborX : { seed.first - 1, seed.first + 1 })
+            {
+                if (neighborX >= 0 && neighborX < width)
+                {
+                    scanColumn(neighborX, neighborFirst, neighborLast);
+                }
+            }
+        }
+        return revealed;
+    }
+
+    // What Press does to a single covered tile: read its state and count,
+    // and reveal it if it's a number. Returns how many were revealed.
+    template <typename Tiles>
+    uint64_t PressTiles(Tiles& tiles, std::vector<uint32_t> const& indices)
+    {
+        uint64_t revealed = 0;
+        for (auto index : indices)
+        {
+            if (tiles.IsCovered(index) && tiles.Count(index) > 0)
+            {
+                tiles.Reveal(index);
+                revealed++;
+            }
+        }
+        return revealed;
+    }
+
+    template <typename Kernel>
+    double MinimumSeconds(Kernel&& kernel)
+    {
+        auto best = std::numeric_limits<double>::max();
+        for (auto run = 0; run < TimedRuns; run++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            kernel();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    struct RecordResults
+    {
+        uint64_t swept = 0;
+        uint64_t pressed = 0;
+        std::vector<uint8_t> packedStates;
+        std::vector<uint8_t> packedMines;
+    };
+
+    template <typename Tiles>
+    void MeasureTiles(RecordBoard const& board, MineBitBoard const& mines, int startX, int startY, std::vector<uint32_t> const& pressIndices, RecordResults& results)
+    {
+        auto tileCount = static_cast<size_t>(board.width) * board.height;
+        auto metric = [](char const* name) { return std::string(Tiles::Name) + "_" + name; };
+        Tiles tiles;
+
+        auto seconds = MinimumSeconds([&]() { tiles.GenerateCounts(mines, tileCount); });
+        PrintResult("record_counts", board.name, metric("mtiles_per_sec").c_str(), tileCount / seconds / 1e6);
+
+        // Covering the board again between runs isn't timed.
+        std::vector<std::pair<int, int>> seeds;
+        auto sweepSeconds = std::numeric_limits<double>::max();
+        for (auto run = 0; run < TimedRuns; run++)
+        {
+            tiles.Cover();
+            auto start = std::chrono::steady_clock::now();
+            results.swept = Sweep(tiles, board.width, board.height, startX, startY, seeds);
+            sweepSeconds = std::min(sweepSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        PrintResult("record_sweep", board.name, metric("mtiles_per_sec").c_str(), results.swept / sweepSeconds / 1e6);
+
+        auto pressSeconds = std::numeric_limits<double>::max();
+        for (auto run = 0; run < TimedRuns; run++)
+        {
+            tiles.Cover();
+            auto start = std::chrono::steady_clock::now();
+            results.pressed = PressTiles(tiles, pressIndices);
+            pressSeconds = std::min(pressSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        PrintResult("record_press", board.name, metric("ns_per_press").c_str(), pressSeconds / pressIndices.size() * 1e9);
+
+        // Snapshot the board half played, the presses above left it that way.
+        results.packedStates.assign((tileCount + 3) / 4, 0);
+        results.packedMines.assign((tileCount + 7) / 8, 0);
+        seconds = MinimumSeconds([&]() { tiles.Pack(results.packedStates.data(), results.packedMines.data(), tileCount); });
+        PrintResult("record_snapshot", board.name, metric("mtiles_per_sec").c_str(), tileCount / seconds / 1e6);
+
+        PrintResult("record", board.name, metric("bytes_per_tile").c_str(), static_cast<double>(tiles.BytesPerTile()));
+    }
+}
+
+void RunRecordBenchmark()
+{
+    MineBitBoard mines;
+    RecordResults split;
+    RecordResults packed;
+    for (auto& board : RecordBoards)
+    {
+        auto tileCount = board.width * board.height;
+        auto middle = (board.width / 2) * board.height + board.height / 2;
+        mines.Reset(board.width, board.height);
+        GenerateMineLayout(1, tileCount / 100 * MinePercent, middle, mines);
+
+        // Start from the first tile with no mines around it, from the middle on.
+        std::vector<int8_t> counts(tileCount);
+        mines.ComputeNeighborCounts(counts.data());
+        auto start = middle;
+        while (counts[start] != 0)
+        {
+            start = (start + 1) % tileCount;
+        }
+
+        // Presses land anywhere, the way clicks on a board this size would.
+        RandomGenerator random(2);
+        std::vector<uint32_t> pressIndices(PressCount);
+        for (auto& index : pressIndices)
+        {
+            index = static_cast<uint32_t>(random.NextBelow(static_cast<uint32_t>(tileCount)));
+        }
+
+        auto startX = start / board.height;
+        auto startY = start % board.height;
+        MeasureTiles<SplitTiles>(board, mines, startX, startY, pressIndices, split);
+        MeasureTiles<PackedTiles>(board, mines, startX, startY, pressIndices, packed);
+
+        // The game's own fill, to show the ported sweep costs what it does.
+        SpanFloodFill floodFill;
+        std::vector<MineState> mineStates;
+        std::vector<TileSpan> revealedSpans;
+        auto spanSeconds = std::numeric_limits<double>::max();
+        for (auto run = 0; run < TimedRuns; run++)
+        {
+            mineStates.assign(tileCount, MineState::Empty);
+            revealedSpans.clear();
+            auto spanStart = std::chrono::steady_clock::now();
+            floodFill.Fill(mineStates.data(), counts.data(), board.width, board.height, startX, startY, revealedSpans);
+            spanSeconds = std::min(spanSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - spanStart).count());
+        }
+        uint64_t spanRevealed = 0;
+        for (auto& span : revealedSpans)
+        {
+            spanRevealed += span.length;
+        }
+        PrintResult("record_sweep", board.name, "span_fill_mtiles_per_sec", spanRevealed / spanSeconds / 1e6);
+
+        PrintResult("record", board.name, "tiles_swept", static_cast<double>(split.swept));
+        PrintResult("record", board.name, "same_result",
+            split.swept == spanRevealed &&
+            split.swept == packed.swept &&
+            split.pressed == packed.pressed &&
+            split.packedStates == packed.packedStates &&
+            split.packedMines == packed.packedMines ? 1.0 : 0.0);
+    }
+}
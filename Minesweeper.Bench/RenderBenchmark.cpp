@@ -0,0 +1,100 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "TileArt.h"
+#include "SoftwareRenderer.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct RenderBoard
+    {
+        char const* name;
+        int width;
+        int height;
+        int mines;
+        int tileSize;
+        int margin;
+    };
+
+    // The classic boards at the size the app draws them, and bigger boards
+    // at thumbnail sizes so the frame stays a reasonable size.
+    const RenderBoard RenderBoards[] =
+    {
+        { "beginner", 9, 9, 10, 25, 2 },
+        { "intermediate", 16, 16, 40, 25, 2 },
+        { "expert", 30, 16, 99, 25, 2 },
+        { "256x256", 256, 256, 13107, 8, 1 },
+        { "1024x1024", 1024, 1024, 209715, 4, 0 },
+    };
+
+    const int PressesPerBoard = 200;
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void RunRenderBenchmark(std::string const& ppmPath)
+{
+    std::vector<uint8_t> ppm;
+    for (auto& board : RenderBoards)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SoftwareRenderer renderer(board.tileSize, board.margin);
+        PrintResult("render", board.name, "atlas_ms", MillisecondsSince(start));
+
+        MinesweeperGame game;
+        game.SetTileUpdateSink(&renderer);
+        game.NewGame(board.width, board.height, board.mines, 1);
+        renderer.Reset(board.width, board.height);
+        start = std::chrono::steady_clock::now();
+        renderer.Render();
+        PrintResult("render", board.name, "full_frame_ms", MillisecondsSince(start));
+
+        // Play random presses, drawing only what each one changed, the way
+        // an interactive frame would.
+        RandomGenerator random(1);
+        std::vector<double> frameTimes;
+        size_t tilesDrawn = 0;
+        game.Press(board.width / 2, board.height / 2, false);
+        for (auto press = 0; press < PressesPerBoard && !game.IsGameOver(); press++)
+        {
+            auto index = static_cast<int>(random.NextBelow(static_cast<uint64_t>(board.width) * board.height));
+            game.Press(index / board.height, index % board.height, random.NextBelow(4) == 0);
+
+            start = std::chrono::steady_clock::now();
+            tilesDrawn += renderer.Render();
+            frameTimes.push_back(MillisecondsSince(start) * 1000.0);
+        }
+        std::sort(frameTimes.begin(), frameTimes.end());
+        if (!frameTimes.empty())
+        {
+            PrintResult("render", board.name, "dirty_frame_us_p50", frameTimes[frameTimes.size() / 2]);
+            PrintResult("render", board.name, "dirty_frame_us_max", frameTimes.back());
+            PrintResult("render", board.name, "tiles_per_dirty_frame", static_cast<double>(tilesDrawn) / frameTimes.size());
+        }
+
+        start = std::chrono::steady_clock::now();
+        renderer.WritePpm(ppm);
+        PrintResult("render", board.name, "ppm_ms", MillisecondsSince(start));
+
+        // The expert board is the one worth looking at.
+        if (!ppmPath.empty() && std::strcmp(board.name, "expert") == 0)
+        {
+            std::ofstream file(ppmPath, std::ios::binary);
+            file.write(reinterpret_cast<char const*>(ppm.data()), ppm.size());
+        }
+    }
+}
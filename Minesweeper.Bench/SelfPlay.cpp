@@ -0,0 +1,135 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "ProbabilitySolver.h"
+#include "SelfPlay.h"
+
+namespace
+{
+    int PickRandomUnrevealedTile(MinesweeperGame const& game, RandomGenerator& random)
+    {
+        // At least one tile is unrevealed while the game is on, and it's
+        // rare for most of them to be gone, so rejection is fast enough.
+        auto tileCount = static_cast<uint64_t>(game.Width()) * game.Height();
+        while (true)
+        {
+            auto index = static_cast<int>(random.NextBelow(tileCount));
+            if (game.MineStates()[index] == MineState::Empty)
+            {
+                return index;
+            }
+        }
+    }
+
+    class RandomPolicy : public SelfPlayPolicy
+    {
+    public:
+        RandomPolicy() : m_random(0) {}
+
+        void Reset(uint64_t seed) override
+        {
+            m_random = RandomGenerator(seed);
+        }
+
+        SelfPlayMove NextMove(MinesweeperGame const& game) override
+        {
+            auto index = PickRandomUnrevealedTile(game, m_random);
+            return { index / game.Height(), index % game.Height(), false };
+        }
+
+    private:
+        RandomGenerator m_random;
+    };
+
+    class SolverPolicy : public SelfPlayPolicy
+    {
+    public:
+        // Every harness thread already has a policy, so the probabilities
+        // are computed on the calling thread only.
+        SolverPolicy() : m_random(0), m_probabilities(1) {}
+
+        void Reset(uint64_t seed) override
+        {
+            m_random = RandomGenerator(seed);
+            m_safeTiles.clear();
+        }
+
+        SelfPlayMove NextMove(MinesweeperGame const& game) override
+        {
+            auto height = game.Height();
+            if (game.Header().mineGenerationState == MineGenerationState::Deferred)
+            {
+                // Nothing is known yet, and the first sweep is always safe.
+                return { game.Width() / 2, height / 2, false };
+            }
+
+            // Tiles proven by an earlier solve may have been opened since.
+            while (!m_safeTiles.empty() && game.MineStates()[m_safeTiles.back()] == MineState::Revealed)
+            {
+                m_safeTiles.pop_back();
+            }
+            if (m_safeTiles.empty())
+            {
+                m_mineTiles.clear();
+                m_solver.Solve(game.Width(), height, game.MineStates(), game.NeighborCounts(), false, m_safeTiles, m_mineTiles);
+            }
+            if (!m_safeTiles.empty())
+            {
+                auto index = m_safeTiles.back();
+                m_safeTiles.pop_back();
+                return { index / height, index % height, false };
+            }
+
+            // Stuck, so guess the tile least likely to be a mine.
+            auto index = -1;
+            if (m_probabilities.Compute(game.Width(), height, game.MineStates(), game.NeighborCounts(), game.Header().numMines, false, m_tileProbabilities))
+            {
+                auto lowest = 2.0;
+                for (size_t i = 0; i < m_tileProbabilities.size(); i++)
+                {
+                    if (game.MineStates()[i] == MineState::Empty && m_tileProbabilities[i] < lowest)
+                    {
+                        lowest = m_tileProbabilities[i];
+                        index = static_cast<int>(i);
+                    }
+                }
+            }
+            if (index < 0)
+            {
+                index = PickRandomUnrevealedTile(game, m_random);
+            }
+            return { index / height, index % height, false };
+        }
+
+    private:
+        RandomGenerator m_random;
+        MineSolver m_solver;
+        ProbabilitySolver m_probabilities;
+        std::vector<int> m_safeTiles;
+        std::vector<int> m_mineTiles;
+        std::vector<double> m_tileProbabilities;
+    };
+}
+
+std::unique_ptr<SelfPlayPolicy> CreateSelfPlayPolicy(std::string const& name)
+{
+    if (name == "random")
+    {
+        return std::make_unique<RandomPolicy>();
+    }
+    if (name == "solver")
+    {
+        return std::make_unique<SolverPolicy>();
+    }
+    return nullptr;
+}
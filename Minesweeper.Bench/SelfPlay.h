@@ -0,0 +1,26 @@
+#pragma once
+
+struct SelfPlayMove
+{
+    int x;
+    int y;
+    bool mark;
+};
+
+// Decides what the self play harness presses next. Each harness thread owns
+// its own policy, so implementations don't need to be thread safe.
+class SelfPlayPolicy
+{
+public:
+    virtual ~SelfPlayPolicy() {}
+
+    // Called before every game with a seed unique to that game.
+    virtual void Reset(uint64_t seed) = 0;
+    // Only called while the game is still being played.
+    virtual SelfPlayMove NextMove(MinesweeperGame const& game) = 0;
+};
+
+// "random" presses any unrevealed tile. "solver" sweeps everything
+// MineSolver proves safe and otherwise the tile ProbabilitySolver rates least
+// likely to be a mine. Returns null for any other name.
+std::unique_ptr<SelfPlayPolicy> CreateSelfPlayPolicy(std::string const& name);
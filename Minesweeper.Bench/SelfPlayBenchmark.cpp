@@ -0,0 +1,140 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "GameProfile.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "SelfPlay.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    // Every density is played on an expert sized board, expert itself is 99.
+    const int BoardWidth = 30;
+    const int BoardHeight = 16;
+    const int DensityMines[] = { 48, 60, 72, 84, 99, 120 };
+    const int DensityCount = static_cast<int>(std::size(DensityMines));
+
+    struct ThreadResult
+    {
+        GameProfile profile;
+        uint64_t tilesRevealed = 0;
+        uint64_t presses = 0;
+        uint64_t games[DensityCount] = {};
+        uint64_t wins[DensityCount] = {};
+    };
+
+    void PlayGames(std::string const& policyName, uint64_t gameCount, std::atomic<uint64_t>& nextGame, ThreadResult& result)
+    {
+        auto policy = CreateSelfPlayPolicy(policyName);
+        MinesweeperGame game;
+        game.SetProfile(&result.profile);
+
+        while (true)
+        {
+            auto gameIndex = nextGame.fetch_add(1);
+            if (gameIndex >= gameCount)
+            {
+                break;
+            }
+
+            // Games are spread over the densities round robin, and the seed
+            // only depends on the game's number, so every run plays the same
+            // boards no matter how many threads there are.
+            auto density = static_cast<int>(gameIndex % DensityCount);
+            game.NewGame(BoardWidth, BoardHeight, DensityMines[density], gameIndex + 1);
+            policy->Reset(gameIndex + 1);
+            while (!game.IsGameOver())
+            {
+                auto move = policy->NextMove(game);
+                game.Press(move.x, move.y, move.mark);
+                result.presses++;
+                for (auto& span : game.RevealedSpans())
+                {
+                    result.tilesRevealed += span.length;
+                }
+            }
+
+            result.games[density]++;
+            if (game.Header().outcome == GameOutcome::Won)
+            {
+                result.wins[density]++;
+            }
+        }
+    }
+
+    void PrintLatency(char const* benchmark, char const* hotPath, LatencyHistogram const& histogram)
+    {
+        char const* metrics[] = { "ns_p50", "ns_p90", "ns_p99", "ns_p999" };
+        double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+        for (auto i = 0; i < 4; i++)
+        {
+            PrintResult(benchmark, hotPath, metrics[i], static_cast<double>(histogram.Percentile(percentiles[i])));
+        }
+    }
+}
+
+bool RunSelfPlayBenchmark(std::string const& policyName, uint64_t gameCount)
+{
+    if (!CreateSelfPlayPolicy(policyName))
+    {
+        return false;
+    }
+    auto benchmark = "selfplay_" + policyName;
+
+    auto threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<ThreadResult> results(threadCount);
+    std::atomic<uint64_t> nextGame = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < results.size(); i++)
+    {
+        threads.emplace_back(PlayGames, std::cref(policyName), gameCount, std::ref(nextGame), std::ref(results[i]));
+    }
+    PlayGames(policyName, gameCount, nextGame, results[0]);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto& total = results[0];
+    for (size_t i = 1; i < results.size(); i++)
+    {
+        total.profile.Merge(results[i].profile);
+        total.tilesRevealed += results[i].tilesRevealed;
+        total.presses += results[i].presses;
+        for (auto density = 0; density < DensityCount; density++)
+        {
+            total.games[density] += results[i].games[density];
+            total.wins[density] += results[i].wins[density];
+        }
+    }
+
+    PrintResult(benchmark.c_str(), "all", "games_per_sec", gameCount / seconds);
+    PrintResult(benchmark.c_str(), "all", "tiles_revealed_per_sec", total.tilesRevealed / seconds);
+    PrintResult(benchmark.c_str(), "all", "presses_per_game", static_cast<double>(total.presses) / gameCount);
+    PrintResult(benchmark.c_str(), "all", "threads", threadCount);
+    for (auto density = 0; density < DensityCount; density++)
+    {
+        if (total.games[density] == 0)
+        {
+            continue;
+        }
+
+        char board[32];
+        snprintf(board, sizeof(board), "%dx%d_%d", BoardWidth, BoardHeight, DensityMines[density]);
+        PrintResult(benchmark.c_str(), board, "win_rate", static_cast<double>(total.wins[density]) / total.games[density]);
+    }
+    PrintLatency(benchmark.c_str(), "sweep", total.profile.sweep);
+    PrintLatency(benchmark.c_str(), "generate_mines", total.profile.generateMines);
+    return true;
+}
@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "Benchmarks.h"
+
+namespace
+{
+    struct VisibleBoard
+    {
+        std::vector<MineState> mineStates;
+        std::vector<int8_t> neighborCounts;
+    };
+
+    const int BoardsPerPreset = 256;
+    const auto MinimumDuration = std::chrono::milliseconds(500);
+
+    // Plays a seeded game with the solver until it has to guess, and keeps
+    // every board it was asked to solve along the way.
+    void CollectBoards(BoardPreset const& preset, uint64_t seed, MineSolver& solver, std::vector<VisibleBoard>& boards)
+    {
+        MinesweeperGame game;
+        game.NewGame(preset.width, preset.height, preset.mines, seed);
+        game.Press(preset.width / 2, preset.height / 2, false);
+
+        auto tileCount = static_cast<size_t>(preset.width) * preset.height;
+        std::vector<int> safeTiles;
+        std::vector<int> mineTiles;
+        while (!game.IsGameOver() && boards.size() < BoardsPerPreset)
+        {
+            boards.push_back({
+                std::vector<MineState>(game.MineStates(), game.MineStates() + tileCount),
+                std::vector<int8_t>(game.NeighborCounts(), game.NeighborCounts() + tileCount) });
+
+            safeTiles.clear();
+            mineTiles.clear();
+            solver.Solve(preset.width, preset.height, game.MineStates(), game.NeighborCounts(), false, safeTiles, mineTiles);
+            if (safeTiles.empty())
+            {
+                break;
+            }
+            for (auto index : safeTiles)
+            {
+                game.Press(game.Indices().ComputeXFromIndex(index), game.Indices().ComputeYFromIndex(index), false);
+            }
+        }
+    }
+}
+
+void RunSolverBenchmark()
+{
+    MineSolver solver;
+    std::vector<int> safeTiles;
+    std::vector<int> mineTiles;
+
+    for (auto& preset : ClassicPresets)
+    {
+        std::vector<VisibleBoard> boards;
+        for (uint64_t seed = 1; boards.size() < BoardsPerPreset; seed++)
+        {
+            CollectBoards(preset, seed, solver, boards);
+        }
+
+        size_t solves = 0;
+        size_t provenTiles = 0;
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::steady_clock::duration::zero();
+        while (elapsed < MinimumDuration)
+        {
+            for (auto& board : boards)
+            {
+                safeTiles.clear();
+                mineTiles.clear();
+                solver.Solve(preset.width, preset.height, board.mineStates.data(), board.neighborCounts.data(), false, safeTiles, mineTiles);
+                provenTiles += safeTiles.size() + mineTiles.size();
+            }
+            solves += boards.size();
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+
+        auto milliseconds = std::chrono::duration<double, std::milli>(elapsed).count();
+        PrintResult("solver", preset.name, "boards_per_ms", solves / milliseconds);
+        PrintResult("solver", preset.name, "proven_tiles_per_board", static_cast<double>(provenTiles) / solves);
+    }
+}
@@ -0,0 +1,133 @@
+#include "pch.h"
+#include "Benchmarks.h"
+
+void PrintResult(char const* benchmark, char const* board, char const* metric, double value)
+{
+    printf("%s,%s,%s,%.3f\n", benchmark, board, metric, value);
+}
+
+int main(int argc, char* argv[])
+{
+    std::string benchmark = argc > 1 ? argv[1] : "all";
+
+    auto ran = false;
+    auto failed = false;
+    if (benchmark == "all" || benchmark == "check")
+    {
+        failed = !RunNeighborCountCheck() || failed;
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "solver")
+    {
+        RunSolverBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "probability")
+    {
+        RunProbabilityBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "noguess")
+    {
+        RunNoGuessBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "micro")
+    {
+        // micro [maximum board side]
+        auto maximumSide = benchmark == "micro" && argc > 2 ? std::atoi(argv[2]) : DefaultMicroMaximumSide;
+        if (maximumSide > 0)
+        {
+            RunMicroBenchmark(maximumSide);
+            ran = true;
+        }
+    }
+    if (benchmark == "all" || benchmark == "density")
+    {
+        RunDensityBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "opening")
+    {
+        // opening [maximum threads]
+        RunOpeningBenchmark(benchmark == "opening" && argc > 2 ? std::atoi(argv[2]) : 0);
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "render")
+    {
+        // render [ppm path]
+        RunRenderBenchmark(benchmark == "render" && argc > 2 ? argv[2] : "");
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "input")
+    {
+        RunInputBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "history")
+    {
+        RunHistoryBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "animation")
+    {
+        RunAnimationBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "preset")
+    {
+        RunPresetBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "layout")
+    {
+        RunLayoutBenchmark();
+        ran = true;
+    }
+    if (benchmark == "all" || benchmark == "record")
+    {
+        RunRecordBenchmark();
+        ran = true;
+    }
+#ifdef _WIN32
+    if (benchmark == "all" || benchmark == "host")
+    {
+        // host [maximum sessions]
+        auto maximumSessions = benchmark == "host" && argc > 2 ? std::atoi(argv[2]) : DefaultHostMaximumSessions;
+        if (maximumSessions > 0)
+        {
+            RunHostBenchmark(maximumSessions);
+            ran = true;
+        }
+    }
+#endif
+    if (benchmark == "all" || benchmark == "endless")
+    {
+        // endless [presses]
+        auto presses = benchmark == "endless" && argc > 2 ? std::strtoull(argv[2], nullptr, 10) : DefaultEndlessPresses;
+        if (presses > 0)
+        {
+            RunEndlessBenchmark(presses);
+            ran = true;
+        }
+    }
+    if (benchmark == "all")
+    {
+        RunSelfPlayBenchmark("random", DefaultSelfPlayGames);
+        RunSelfPlayBenchmark("solver", DefaultSelfPlayGames);
+    }
+    else if (benchmark == "selfplay")
+    {
+        // selfplay [policy] [games]
+        std::string policy = argc > 2 ? argv[2] : "solver";
+        auto games = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : DefaultSelfPlayGames;
+        ran = games > 0 && RunSelfPlayBenchmark(policy, games);
+    }
+
+    if (!ran)
+    {
+        fprintf(stderr, "Usage: Minesweeper.Bench [all|check|solver|probability|noguess|micro [side]|density|opening [threads]|render [ppm]|input|history|animation|preset|layout|record|host [sessions]|endless [presses]|selfplay [random|solver] [games]]\n");
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
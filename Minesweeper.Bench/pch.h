@@ -0,0 +1,59 @@
+#pragma once
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <windows.h>
+
+// WinRT
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.Foundation.Numerics.h>
+#include <winrt/Windows.Graphics.h>
+#include <winrt/Windows.UI.Composition.h>
+#endif
+
+// STL
+#include <vector>
+#include <array>
+#include <random>
+#include <queue>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <string>
+#include <cstring>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <limits>
+#include <bitset>
+#include <functional>
+#include <deque>
+#include <unordered_map>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+// Must match msweepcore's pch.h, the core headers depend on it.
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <immintrin.h>
+#define MSWEEP_AVX2_AVAILABLE 1
+#define MSWEEP_AVX2_TARGET
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MSWEEP_AVX2_AVAILABLE 1
+#define MSWEEP_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define MSWEEP_AVX2_AVAILABLE 0
+#endif
+
+// Minesweeper
+#include "msweepcore.h"
+#include "IndexHelper.h"
+#include "PaddedLayout.h"
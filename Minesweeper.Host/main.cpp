@@ -0,0 +1,40 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "HostProtocol.h"
+#include "GameHost.h"
+
+int main(int argc, char* argv[])
+{
+    // Minesweeper.Host [port] [workers]
+    auto port = argc > 1 ? std::atoi(argv[1]) : 0;
+    auto workerCount = argc > 2 ? std::atoi(argv[2]) : 0;
+    if (port < 0 || port > std::numeric_limits<uint16_t>::max() || workerCount < 0)
+    {
+        fprintf(stderr, "Usage: Minesweeper.Host [port] [workers]\n");
+        return 1;
+    }
+
+    try
+    {
+        GameHost host(static_cast<uint16_t>(port), workerCount);
+        printf("Serving games on 127.0.0.1:%d with %d workers, press Enter to stop.\n", host.Port(), host.WorkerCount());
+        getchar();
+        printf("Served %llu sessions.\n", static_cast<unsigned long long>(host.SessionsStarted()));
+    }
+    catch (winrt::hresult_error const& error)
+    {
+        fprintf(stderr, "Couldn't start the host: 0x%08x\n", static_cast<uint32_t>(error.code()));
+        return 1;
+    }
+    return 0;
+}
@@ -12,6 +12,10 @@ namespace winrt
 
 const std::wstring MainWindow::ClassName = L"Minesweeper.Win32.MainWindow";
 
+// Asks for a frame about once a display refresh while an animation plays.
+static const UINT_PTR AnimationTimerId = 1;
+static const UINT AnimationFrameMilliseconds = 16;
+
 void MainWindow::RegisterWindowClass()
 {
     auto instance = winrt::check_pointer(GetModuleHandleW(nullptr));
@@ -59,6 +63,7 @@ LRESULT MainWindow::MessageHandler(UINT const message, WPARAM const wparam, LPAR
         auto rawY = GET_Y_LPARAM(lparam);
         winrt::float2 point = { (float)rawX, (float)rawY };
         m_game->OnPointerMoved(point);
+        ScheduleInput();
     }
         break;
     case WM_SIZE:
@@ -70,15 +75,62 @@ LRESULT MainWindow::MessageHandler(UINT const message, WPARAM const wparam, LPAR
         break;
     case WM_LBUTTONDOWN:
         m_game->OnPointerPressed(false, false);
+        ScheduleInput();
         break;
     case WM_RBUTTONDOWN:
         m_game->OnPointerPressed(true, false);
+        ScheduleInput();
+        break;
+    case WM_KEYDOWN:
+        if (GetKeyState(VK_CONTROL) < 0)
+        {
+            if (wparam == 'Z')
+            {
+                m_game->Undo();
+            }
+            else if (wparam == 'Y')
+            {
+                m_game->Redo();
+            }
+        }
+        break;
+    case WM_PAINT:
+        // WM_PAINT only comes once the input messages have been drained, so
+        // everything that arrived since the last frame is handled together.
+        winrt::check_bool(ValidateRect(m_window, nullptr));
+        m_game->ProcessInput();
+        UpdateAnimation();
+        break;
+    case WM_TIMER:
+        if (wparam == AnimationTimerId)
+        {
+            ScheduleInput();
+        }
         break;
     }
 
     return base_type::MessageHandler(message, wparam, lparam);
 }
 
+void MainWindow::ScheduleInput()
+{
+    winrt::check_bool(InvalidateRect(m_window, nullptr, false));
+}
+
+void MainWindow::UpdateAnimation()
+{
+    auto animating = m_game->Animate();
+    if (animating && !m_animating)
+    {
+        winrt::check_bool(SetTimer(m_window, AnimationTimerId, AnimationFrameMilliseconds, nullptr));
+    }
+    else if (!animating && m_animating)
+    {
+        winrt::check_bool(KillTimer(m_window, AnimationTimerId));
+    }
+    m_animating = animating;
+}
+
 winrt::Windows::Graphics::SizeInt32 MainWindow::GetWindowSize()
 {
     RECT rect = {};
@@ -12,8 +12,11 @@ struct MainWindow : robmikh::common::desktop::DesktopWindow<MainWindow>
     LRESULT MessageHandler(UINT const message, WPARAM const wparam, LPARAM const lparam);
 
 private:
+    void ScheduleInput();
+    void UpdateAnimation();
     winrt::Windows::Graphics::SizeInt32 GetWindowSize();
 
 private:
     std::shared_ptr<IMinesweeper> m_game;
+    bool m_animating = false;
 };
\ No newline at end of file
@@ -34,6 +34,8 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView>
         m_sizeChanged.revoke();
         m_pointerMoved.revoke();
         m_pointerPressed.revoke();
+        m_keyDown.revoke();
+        m_animationTick.revoke();
     }
 
     void Run()
@@ -49,6 +51,15 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView>
         m_sizeChanged = m_window.SizeChanged(auto_revoke, { this, &App::OnSizeChanged });
         m_pointerMoved = m_window.PointerMoved(auto_revoke, { this, &App::OnPointerMoved });
         m_pointerPressed = m_window.PointerPressed(auto_revoke, { this, &App::OnPointerPressed });
+        m_keyDown = m_window.KeyDown(auto_revoke, { this, &App::OnKeyDown });
+
+        // Asks for a frame about once a display refresh while an animation plays.
+        m_animationTimer = DispatcherQueue::GetForCurrentThread().CreateTimer();
+        m_animationTimer.Interval(std::chrono::milliseconds(16));
+        m_animationTick = m_animationTimer.Tick(auto_revoke, [this](auto&&, auto&&)
+        {
+            ScheduleInput();
+        });
 
         m_window.Activate();
 
@@ -76,6 +87,7 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView>
     {
         float2 point = args.CurrentPoint().Position();
         m_minesweeper->OnPointerMoved(point);
+        ScheduleInput();
     }
 
     void OnPointerPressed(IInspectable const & window, PointerEventArgs const & args)
@@ -83,6 +95,49 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView>
         m_minesweeper->OnPointerPressed(
             args.CurrentPoint().Properties().IsRightButtonPressed(),
             args.CurrentPoint().Properties().IsEraser());
+        ScheduleInput();
+    }
+
+    void OnKeyDown(CoreWindow const & window, KeyEventArgs const & args)
+    {
+        auto controlState = window.GetKeyState(VirtualKey::Control);
+        if ((controlState & CoreVirtualKeyStates::Down) != CoreVirtualKeyStates::Down)
+        {
+            return;
+        }
+
+        if (args.VirtualKey() == VirtualKey::Z)
+        {
+            m_minesweeper->Undo();
+        }
+        else if (args.VirtualKey() == VirtualKey::Y)
+        {
+            m_minesweeper->Redo();
+        }
+    }
+
+    void ScheduleInput()
+    {
+        // Low priority work runs after the pending pointer events, so a
+        // burst of moves is handled once.
+        if (m_inputScheduled)
+        {
+            return;
+        }
+        m_inputScheduled = true;
+        m_window.Dispatcher().RunAsync(CoreDispatcherPriority::Low, [this]()
+        {
+            m_inputScheduled = false;
+            m_minesweeper->ProcessInput();
+            if (m_minesweeper->Animate())
+            {
+                m_animationTimer.Start();
+            }
+            else
+            {
+                m_animationTimer.Stop();
+            }
+        });
     }
 
     CoreApplicationView m_view{ nullptr };
@@ -93,10 +148,14 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView>
     ContainerVisual m_windowRoot{ nullptr };
 
     std::shared_ptr<IMinesweeper> m_minesweeper{ nullptr };
+    bool m_inputScheduled = false;
+    DispatcherQueueTimer m_animationTimer{ nullptr };
 
     CoreWindow::SizeChanged_revoker m_sizeChanged;
     CoreWindow::PointerMoved_revoker m_pointerMoved;
     CoreWindow::PointerPressed_revoker m_pointerPressed;
+    CoreWindow::KeyDown_revoker m_keyDown;
+    DispatcherQueueTimer::Tick_revoker m_animationTick;
 };
 
 int __stdcall wWinMain(HINSTANCE, HINSTANCE, PWSTR, int)
@@ -0,0 +1,288 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "TilePacking.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+
+static_assert(offsetof(SnapshotHeader, checksum) + sizeof(uint64_t) == sizeof(SnapshotHeader), "The checksum has to be the last field of the snapshot header.");
+
+namespace
+{
+    uint64_t Fnv1a(uint64_t hash, uint8_t const* data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= data[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    uint64_t ComputeChecksum(SnapshotHeader const& header, uint8_t const* payload, size_t payloadSize)
+    {
+        // The checksum is the last field, everything before it is covered.
+        auto hash = Fnv1a(0xcbf29ce484222325ull, reinterpret_cast<uint8_t const*>(&header), offsetof(SnapshotHeader, checksum));
+        return Fnv1a(hash, payload, payloadSize);
+    }
+
+    inline uint64_t CountBits(uint64_t value)
+    {
+        return std::bitset<64>(value).count();
+    }
+
+    // Counts the tiles whose packed state has both bits set (Revealed) and
+    // only the low bit set (Flag), 32 tiles a word.
+    void CountTileStates(uint8_t const* packed, size_t tileCount, uint64_t& revealedTiles, uint64_t& flaggedTiles)
+    {
+        const uint64_t lowBits = 0x5555555555555555ull;
+        revealedTiles = 0;
+        flaggedTiles = 0;
+        size_t i = 0;
+        for (; i + 32 <= tileCount; i += 32)
+        {
+            uint64_t word;
+            memcpy(&word, packed + i / 4, sizeof(word));
+            revealedTiles += CountBits(word & (word >> 1) & lowBits);
+            flaggedTiles += CountBits(word & ~(word >> 1) & lowBits);
+        }
+        for (; i < tileCount; i++)
+        {
+            auto state = (packed[i / 4] >> ((i % 4) * 2)) & 0x3;
+            revealedTiles += state == static_cast<uint8_t>(MineState::Revealed) ? 1 : 0;
+            flaggedTiles += state == static_cast<uint8_t>(MineState::Flag) ? 1 : 0;
+        }
+    }
+
+    uint64_t CountMines(uint8_t const* bits, size_t tileCount)
+    {
+        uint64_t mines = 0;
+        size_t i = 0;
+        for (; i + 64 <= tileCount; i += 64)
+        {
+            uint64_t word;
+            memcpy(&word, bits + i / 8, sizeof(word));
+            mines += CountBits(word);
+        }
+        for (; i < tileCount; i++)
+        {
+            mines += (bits[i / 8] >> (i % 8)) & 1;
+        }
+        return mines;
+    }
+
+    // Fills in everything but the checksum and sizes output to hold the
+    // snapshot, with the payload zeroed.
+    SnapshotHeader StartSnapshot(BoardHeader const& board, SnapshotMineEncoding mineEncoding, std::vector<uint8_t>& output)
+    {
+        auto tileCount = static_cast<size_t>(board.width) * board.height;
+
+        SnapshotHeader header = {};
+        header.magic = SnapshotHeader::ExpectedMagic;
+        header.version = SnapshotHeader::CurrentVersion;
+        header.mineEncoding = mineEncoding;
+        header.mineGenerationState = board.mineGenerationState;
+        header.width = board.width;
+        header.height = board.height;
+        header.numMines = board.numMines;
+        header.unrevealedTiles = board.unrevealedTiles;
+        header.flagsPlaced = board.flagsPlaced;
+        header.firstClickIndex = board.firstClickIndex;
+        header.outcome = board.outcome;
+        header.seed = board.seed;
+        header.tileStatesSize = (tileCount + 3) / 4;
+        header.minesSize = mineEncoding == SnapshotMineEncoding::Bitmap ? (tileCount + 7) / 8 : 0;
+
+        output.assign(sizeof(SnapshotHeader) + static_cast<size_t>(header.tileStatesSize + header.minesSize), 0);
+        return header;
+    }
+
+    void FinishSnapshot(SnapshotHeader& header, std::vector<uint8_t>& output)
+    {
+        auto payload = output.data() + sizeof(SnapshotHeader);
+        header.checksum = ComputeChecksum(header, payload, static_cast<size_t>(header.tileStatesSize + header.minesSize));
+        memcpy(output.data(), &header, sizeof(header));
+    }
+}
+
+SnapshotView::SnapshotView(uint8_t const* data, size_t size)
+{
+    if (size < sizeof(SnapshotHeader))
+    {
+        throw std::runtime_error("The snapshot is too small!");
+    }
+
+    m_header = reinterpret_cast<SnapshotHeader const*>(data);
+    if (m_header->magic != SnapshotHeader::ExpectedMagic || m_header->version != SnapshotHeader::CurrentVersion)
+    {
+        throw std::runtime_error("The buffer isn't a snapshot this version understands!");
+    }
+
+    auto tileCount = static_cast<uint64_t>(m_header->width) * m_header->height;
+    auto hasBitmap = m_header->mineEncoding == SnapshotMineEncoding::Bitmap;
+    if (m_header->width <= 0 ||
+        m_header->height <= 0 ||
+        tileCount > static_cast<uint64_t>(std::numeric_limits<int32_t>::max()) ||
+        m_header->tileStatesSize != (tileCount + 3) / 4 ||
+        m_header->minesSize != (hasBitmap ? (tileCount + 7) / 8 : 0) ||
+        size - sizeof(SnapshotHeader) < m_header->tileStatesSize + m_header->minesSize)
+    {
+        throw std::runtime_error("The snapshot is truncated!");
+    }
+
+    if (m_header->mineGenerationState == MineGenerationState::Generated &&
+        !hasBitmap &&
+        (m_header->firstClickIndex < 0 || static_cast<uint64_t>(m_header->firstClickIndex) >= tileCount))
+    {
+        throw std::runtime_error("The snapshot's seeded layout has no first click!");
+    }
+
+    auto payload = data + sizeof(SnapshotHeader);
+    auto payloadSize = static_cast<size_t>(m_header->tileStatesSize + m_header->minesSize);
+    if (ComputeChecksum(*m_header, payload, payloadSize) != m_header->checksum)
+    {
+        throw std::runtime_error("The snapshot is corrupt!");
+    }
+
+    m_tileStates = payload;
+    if (hasBitmap)
+    {
+        m_mines = payload + m_header->tileStatesSize;
+    }
+
+    // A checksum only proves the snapshot wasn't damaged on the way, not that
+    // whoever wrote it kept the counters honest. The game trusts them to
+    // decide when it's won and how many mines are left.
+    if (m_header->numMines < 0 ||
+        static_cast<uint64_t>(m_header->numMines) >= tileCount ||
+        m_header->mineGenerationState > MineGenerationState::Generated ||
+        m_header->outcome > GameOutcome::Lost)
+    {
+        throw std::runtime_error("The snapshot has an invalid header!");
+    }
+
+    uint64_t revealedTiles = 0;
+    uint64_t flaggedTiles = 0;
+    CountTileStates(m_tileStates, static_cast<size_t>(tileCount), revealedTiles, flaggedTiles);
+    if (static_cast<uint64_t>(m_header->unrevealedTiles) != tileCount - revealedTiles ||
+        static_cast<uint64_t>(m_header->flagsPlaced) != flaggedTiles ||
+        (hasBitmap && CountMines(m_mines, static_cast<size_t>(tileCount)) != static_cast<uint64_t>(m_header->numMines)))
+    {
+        throw std::runtime_error("The snapshot's counters don't match its tiles!");
+    }
+}
+
+void WriteSnapshot(
+    BoardHeader const& board,
+    MineState const* mineStates,
+    int8_t const* neighborCounts,
+    SnapshotMineEncoding mineEncoding,
+    std::vector<uint8_t>& output)
+{
+    auto tileCount = static_cast<size_t>(board.width) * board.height;
+    auto header = StartSnapshot(board, mineEncoding, output);
+    auto payload = output.data() + sizeof(SnapshotHeader);
+
+    PackTileStates(mineStates, tileCount, payload);
+    if (mineEncoding == SnapshotMineEncoding::Bitmap && board.mineGenerationState == MineGenerationState::Generated)
+    {
+        PackMines(neighborCounts, tileCount, payload + header.tileStatesSize);
+    }
+
+    FinishSnapshot(header, output);
+}
+
+void WriteSnapshot(BoardVersion const& version, SnapshotMineEncoding mineEncoding, std::vector<uint8_t>& output)
+{
+    auto header = StartSnapshot(version.header, mineEncoding, output);
+    auto payload = output.data() + sizeof(SnapshotHeader);
+    auto packMines = mineEncoding == SnapshotMineEncoding::Bitmap && version.header.mineGenerationState == MineGenerationState::Generated;
+
+    // Chunks hold a multiple of eight tiles, so every chunk but the last
+    // packs into whole bytes of its own.
+    static_assert(TileChunks::ChunkTiles % 8 == 0, "Chunks have to pack into whole bytes.");
+    for (size_t chunk = 0; chunk < version.mineStates.ChunkCount(); chunk++)
+    {
+        auto first = chunk * TileChunks::ChunkTiles;
+        auto size = version.mineStates.ChunkSize(chunk);
+        PackTileStates(reinterpret_cast<MineState const*>(version.mineStates.Chunk(chunk)), size, payload + first / 4);
+        if (packMines)
+        {
+            PackMines(reinterpret_cast<int8_t const*>(version.neighborCounts.Chunk(chunk)), size, payload + header.tileStatesSize + first / 8);
+        }
+    }
+
+    FinishSnapshot(header, output);
+}
+
+SnapshotAutosaver::SnapshotAutosaver(std::wstring const& path, SnapshotMineEncoding mineEncoding)
+{
+    m_path = path;
+    m_mineEncoding = mineEncoding;
+    m_thread = std::thread([this]() { Run(); });
+}
+
+SnapshotAutosaver::~SnapshotAutosaver()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+void SnapshotAutosaver::Submit(BoardVersion const& version)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_pending = version;
+        m_hasPending = true;
+    }
+    m_condition.notify_one();
+}
+
+void SnapshotAutosaver::Run()
+{
+    BoardVersion writing;
+    std::vector<uint8_t> snapshot;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.wait(lock, [this]() { return m_hasPending || m_stopping; });
+            if (!m_hasPending)
+            {
+                return;
+            }
+            std::swap(writing, m_pending);
+            m_hasPending = false;
+        }
+
+        // Any version submitted while this one is written replaces it in
+        // m_pending. Letting go of the chunks straight after lets the game
+        // write to them in place again.
+        WriteSnapshot(writing, m_mineEncoding, snapshot);
+        writing = BoardVersion();
+        WriteToDisk(snapshot);
+    }
+}
+
+void SnapshotAutosaver::WriteToDisk(std::vector<uint8_t> const& snapshot)
+{
+    // Write next to the old save and swap it in, so a crash mid-write never
+    // leaves a torn snapshot behind.
+    auto temporaryPath = m_path;
+    temporaryPath += L".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<char const*>(snapshot.data()), snapshot.size());
+        if (!file)
+        {
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, m_path, error);
+}
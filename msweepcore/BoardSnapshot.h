@@ -0,0 +1,98 @@
+#pragma once
+
+enum class SnapshotMineEncoding : uint8_t
+{
+    // The layout is regenerated from the seed and the first click.
+    Seed = 0,
+    // The layout is stored as one bit per tile.
+    Bitmap = 1,
+};
+
+// A snapshot is this header followed by the tile states packed two bits per
+// tile and, for bitmap encoded layouts, the mines packed one bit per tile.
+// Both are in IndexHelper order.
+struct SnapshotHeader
+{
+    static const uint32_t ExpectedMagic = 0x5357534d; // "MSWS"
+    static const uint16_t CurrentVersion = 2;
+
+    uint32_t magic;
+    uint16_t version;
+    SnapshotMineEncoding mineEncoding;
+    MineGenerationState mineGenerationState;
+    int32_t width;
+    int32_t height;
+    int32_t numMines;
+    int32_t unrevealedTiles;
+    int32_t flagsPlaced;
+    int32_t firstClickIndex;
+    GameOutcome outcome;
+    uint8_t reserved[7];
+    uint64_t seed;
+    uint64_t tileStatesSize;
+    uint64_t minesSize;
+    // FNV-1a over the rest of the header and the payload.
+    uint64_t checksum;
+};
+
+// Reads a snapshot in place. Nothing is copied, so a snapshot can be used
+// straight out of a mapped file or a network buffer. Throws if the buffer
+// isn't a complete, intact snapshot, or if its mine count doesn't leave a
+// tile free or its counters don't match its tiles.
+class SnapshotView
+{
+public:
+    SnapshotView(uint8_t const* data, size_t size);
+    ~SnapshotView() {}
+
+    SnapshotHeader const& Header() const { return *m_header; }
+    MineState TileState(size_t index) const { return static_cast<MineState>((m_tileStates[index / 4] >> ((index % 4) * 2)) & 0x3); }
+    bool HasMineBitmap() const { return m_mines != nullptr; }
+    bool IsMine(size_t index) const { return (m_mines[index / 8] >> (index % 8)) & 1; }
+    // The packed arrays themselves, for converting the whole board at once
+    // (see TilePacking.h). PackedMines is null without a bitmap.
+    uint8_t const* PackedTileStates() const { return m_tileStates; }
+    uint8_t const* PackedMines() const { return m_mines; }
+
+private:
+    SnapshotHeader const* m_header = nullptr;
+    uint8_t const* m_tileStates = nullptr;
+    uint8_t const* m_mines = nullptr;
+};
+
+// Serializes a board into output, reusing its capacity.
+void WriteSnapshot(
+    BoardHeader const& board,
+    MineState const* mineStates,
+    int8_t const* neighborCounts,
+    SnapshotMineEncoding mineEncoding,
+    std::vector<uint8_t>& output);
+// The same, reading the tiles a chunk at a time out of a version.
+void WriteSnapshot(BoardVersion const& version, SnapshotMineEncoding mineEncoding, std::vector<uint8_t>& output);
+
+// Serializes and writes snapshots to disk on a background thread. Submit
+// only copies the version, which shares its chunks with the caller's, so the
+// caller pays for neither the serializing nor the disk I/O. Only the newest
+// pending version is written.
+class SnapshotAutosaver
+{
+public:
+    SnapshotAutosaver(std::wstring const& path, SnapshotMineEncoding mineEncoding);
+    ~SnapshotAutosaver();
+
+    void Submit(BoardVersion const& version);
+
+private:
+    void Run();
+    void WriteToDisk(std::vector<uint8_t> const& snapshot);
+
+private:
+    std::filesystem::path m_path;
+    SnapshotMineEncoding m_mineEncoding;
+    std::mutex m_lock;
+    std::condition_variable m_condition;
+    BoardVersion m_pending;
+    bool m_hasPending = false;
+    bool m_stopping = false;
+    std::thread m_thread;
+};
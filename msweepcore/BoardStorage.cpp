@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "BoardStorage.h"
+
+static_assert(sizeof(BoardHeader) <= 64, "The board header has to fit in front of the tiles.");
+
+void BoardStorage::Create(int width, int height)
+{
+    // The heap block is kept, a board that fits in it doesn't allocate.
+    CloseMapping();
+
+    m_tileCount = static_cast<size_t>(width) * height;
+    m_heap.assign(ComputeSize(m_tileCount), 0);
+    m_data = m_heap.data();
+    InitializeHeader(width, height);
+}
+
+#ifdef _WIN32
+void BoardStorage::CreateMapped(std::wstring const& path, int width, int height)
+{
+    Close();
+
+    m_tileCount = static_cast<size_t>(width) * height;
+    OpenFile(path);
+    // Start from an empty file, mapping it at the new size zero fills it.
+    winrt::check_bool(SetFilePointerEx(m_file.get(), {}, nullptr, FILE_BEGIN));
+    winrt::check_bool(SetEndOfFile(m_file.get()));
+    MapFile(ComputeSize(m_tileCount));
+    InitializeHeader(width, height);
+}
+
+bool BoardStorage::OpenMapped(std::wstring const& path)
+{
+    Close();
+
+    OpenFile(path);
+    LARGE_INTEGER fileSize = {};
+    winrt::check_bool(GetFileSizeEx(m_file.get(), &fileSize));
+    if (fileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    if (fileSize.QuadPart < sizeof(BoardHeader))
+    {
+        Close();
+        throw std::runtime_error("The board file is too small to hold a board!");
+    }
+
+    MapFile(fileSize.QuadPart);
+    auto header = Header();
+    if (header->magic != BoardHeader::ExpectedMagic || header->version != BoardHeader::CurrentVersion)
+    {
+        Close();
+        throw std::runtime_error("The file doesn't contain a board!");
+    }
+
+    m_tileCount = static_cast<size_t>(header->width) * header->height;
+    if (header->width <= 0 || header->height <= 0 || static_cast<uint64_t>(fileSize.QuadPart) < ComputeSize(m_tileCount))
+    {
+        Close();
+        throw std::runtime_error("The board file is truncated!");
+    }
+
+    return true;
+}
+#endif
+
+void BoardStorage::Close()
+{
+    CloseMapping();
+
+    m_heap.clear();
+    m_heap.shrink_to_fit();
+}
+
+void BoardStorage::CloseMapping()
+{
+#ifdef _WIN32
+    if (m_view != nullptr)
+    {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    m_mapping.close();
+    m_file.close();
+#endif
+
+    m_data = nullptr;
+    m_tileCount = 0;
+}
+
+#ifdef _WIN32
+void BoardStorage::OpenFile(std::wstring const& path)
+{
+    // CreateFile2 and the FromApp mapping functions work for both the desktop
+    // and the UWP builds.
+    m_file.attach(CreateFile2(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, OPEN_ALWAYS, nullptr));
+    if (!m_file)
+    {
+        winrt::throw_last_error();
+    }
+}
+
+void BoardStorage::MapFile(uint64_t size)
+{
+    m_mapping.attach(CreateFileMappingFromApp(m_file.get(), nullptr, PAGE_READWRITE, size, nullptr));
+    if (!m_mapping)
+    {
+        winrt::throw_last_error();
+    }
+
+    m_view = MapViewOfFileFromApp(m_mapping.get(), FILE_MAP_READ | FILE_MAP_WRITE, 0, static_cast<size_t>(size));
+    winrt::check_pointer(m_view);
+    m_data = static_cast<uint8_t*>(m_view);
+}
+#endif
+
+void BoardStorage::InitializeHeader(int width, int height)
+{
+    // Everything else starts zeroed, which is MineState::Empty for every tile.
+    auto header = Header();
+    header->magic = BoardHeader::ExpectedMagic;
+    header->version = BoardHeader::CurrentVersion;
+    header->width = width;
+    header->height = height;
+    header->unrevealedTiles = width * height;
+    header->mineGenerationState = MineGenerationState::Deferred;
+    header->outcome = GameOutcome::Playing;
+    header->firstClickIndex = -1;
+}
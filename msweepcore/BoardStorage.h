@@ -0,0 +1,81 @@
+#pragma once
+
+// Sits at the start of a board's storage. When the board is backed by a file
+// this is all the bookkeeping needed to pick the game back up.
+struct BoardHeader
+{
+    static const uint32_t ExpectedMagic = 0x4257534d; // "MSWB"
+    static const uint32_t CurrentVersion = 3;
+
+    uint32_t magic;
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t numMines;
+    int32_t unrevealedTiles;
+    int32_t flagsPlaced;
+    MineGenerationState mineGenerationState;
+    GameOutcome outcome;
+    uint64_t seed;
+    // Where the player first clicked, together with the seed this reproduces the mine layout.
+    int32_t firstClickIndex;
+};
+
+// Owns the per tile state of a board: one MineState byte per tile followed by
+// one neighbor count byte per tile (-1 means a mine), both in IndexHelper
+// order. The storage either lives on the heap or is a memory mapped file, in
+// which case every change is written through to the file as the game is
+// played and there is no separate save step. Mapped files are Windows only.
+//
+// The two arrays aren't folded into one byte per tile (a mine bit, a count
+// and a state). Minesweeper.Bench's record benchmark measures that record
+// against them: it halves memory and makes presses on boards past the caches
+// and snapshot packing cheaper, but sweeps and neighbor counts gain nothing,
+// and both savings are small next to what a press or a save costs as a
+// whole. The flood fills, solvers, preset kernels, board versions, renderer
+// and mapped files would all have to change with it. Snapshots store the
+// packed forms instead, see TilePacking.h.
+class BoardStorage
+{
+public:
+    BoardStorage() {}
+    ~BoardStorage() { Close(); }
+
+    // Reuses the heap block of the last board created when it's big enough.
+    void Create(int width, int height);
+#ifdef _WIN32
+    void CreateMapped(std::wstring const& path, int width, int height);
+    // Returns false if the file is new or empty, in which case nothing is mapped.
+    bool OpenMapped(std::wstring const& path);
+#endif
+    void Close();
+
+    bool IsMapped() const { return m_view != nullptr; }
+    size_t TileCount() const { return m_tileCount; }
+    BoardHeader* Header() { return reinterpret_cast<BoardHeader*>(m_data); }
+    MineState* MineStates() { return reinterpret_cast<MineState*>(m_data + TilesOffset); }
+    int8_t* NeighborCounts() { return reinterpret_cast<int8_t*>(m_data + TilesOffset + AlignedTileCount(m_tileCount)); }
+
+private:
+    static const size_t TilesOffset = 64;
+    static size_t AlignedTileCount(size_t tileCount) { return (tileCount + 63) & ~static_cast<size_t>(63); }
+    static size_t ComputeSize(size_t tileCount) { return TilesOffset + AlignedTileCount(tileCount) * 2; }
+
+    void CloseMapping();
+#ifdef _WIN32
+    void OpenFile(std::wstring const& path);
+    void MapFile(uint64_t size);
+#endif
+    void InitializeHeader(int width, int height);
+
+private:
+    size_t m_tileCount = 0;
+    uint8_t* m_data = nullptr;
+    std::vector<uint8_t> m_heap;
+
+#ifdef _WIN32
+    winrt::file_handle m_file;
+    winrt::handle m_mapping;
+#endif
+    void* m_view = nullptr;
+};
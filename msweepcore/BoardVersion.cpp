@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+
+void TileChunks::Assign(uint8_t const* tiles, size_t size)
+{
+    m_size = size;
+    m_tables.clear();
+    m_tables.resize((ChunkCount() + ChunksPerTable - 1) / ChunksPerTable);
+    for (auto& table : m_tables)
+    {
+        table = std::make_shared<Table>();
+    }
+    for (size_t chunk = 0; chunk < ChunkCount(); chunk++)
+    {
+        WriteChunk(tiles, chunk);
+    }
+}
+
+void TileChunks::WriteChunk(uint8_t const* tiles, size_t chunk)
+{
+    // Whatever another array can still see gets copied first: the table so
+    // that this array can point it somewhere else, and the chunk, which
+    // doesn't need its old tiles since all of them are about to change.
+    auto& table = m_tables[chunk / ChunksPerTable];
+    if (table.use_count() > 1)
+    {
+        table = std::make_shared<Table>(*table);
+    }
+    auto& data = (*table)[chunk % ChunksPerTable];
+    if (data.use_count() != 1)
+    {
+        data = std::make_shared<ChunkData>();
+    }
+    std::memcpy(data->data(), tiles + chunk * ChunkTiles, ChunkSize(chunk));
+}
+
+size_t TileChunks::BytesNotSharedWith(TileChunks const& other) const
+{
+    auto sameSize = m_size == other.m_size;
+    auto bytes = m_tables.size() * sizeof(m_tables[0]);
+    for (size_t table = 0; table < m_tables.size(); table++)
+    {
+        if (sameSize && SharesTable(other, table))
+        {
+            continue;
+        }
+
+        bytes += sizeof(Table);
+        auto end = std::min(ChunkCount(), (table + 1) * ChunksPerTable);
+        for (auto chunk = table * ChunksPerTable; chunk < end; chunk++)
+        {
+            if (!sameSize || !SharesChunk(other, chunk))
+            {
+                bytes += sizeof(ChunkData);
+            }
+        }
+    }
+    return bytes;
+}
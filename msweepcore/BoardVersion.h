@@ -0,0 +1,59 @@
+#pragma once
+
+// A copy on write array of tile bytes. The tiles are split into chunks of
+// ChunkTiles, and copies share chunks until one of them writes to one.
+// Copying the array copies one table pointer per ChunksPerTable chunks,
+// and writing a chunk copies at most that chunk and its table.
+class TileChunks
+{
+public:
+    static constexpr size_t ChunkTiles = 1024;
+    static constexpr size_t ChunksPerTable = 64;
+
+    TileChunks() {}
+
+    size_t Size() const { return m_size; }
+    size_t ChunkCount() const { return (m_size + ChunkTiles - 1) / ChunkTiles; }
+    size_t TableCount() const { return m_tables.size(); }
+    // How many tiles the chunk holds, only the last one can be short.
+    size_t ChunkSize(size_t chunk) const { return std::min(ChunkTiles, m_size - chunk * ChunkTiles); }
+    uint8_t const* Chunk(size_t chunk) const { return (*m_tables[chunk / ChunksPerTable])[chunk % ChunksPerTable]->data(); }
+
+    // Copies every tile, sharing nothing with any other array.
+    void Assign(uint8_t const* tiles, size_t size);
+    // Copies the chunk out of tiles, which holds the whole board.
+    void WriteChunk(uint8_t const* tiles, size_t chunk);
+
+    // Both arrays must be the same size. Shared chunks hold the same tiles
+    // without having to look at them.
+    bool SharesTable(TileChunks const& other, size_t table) const { return m_tables[table] == other.m_tables[table]; }
+    bool SharesChunk(TileChunks const& other, size_t chunk) const { return Chunk(chunk) == other.Chunk(chunk); }
+
+    // The bytes of tables and chunks that this array doesn't share with other.
+    size_t BytesNotSharedWith(TileChunks const& other) const;
+
+private:
+    using ChunkData = std::array<uint8_t, ChunkTiles>;
+    using Table = std::array<std::shared_ptr<ChunkData>, ChunksPerTable>;
+
+private:
+    size_t m_size = 0;
+    // Tables and chunks are only ever written while this array is their
+    // only owner, everything shared is treated as immutable.
+    std::vector<std::shared_ptr<Table>> m_tables;
+};
+
+// Everything about a board at one point in a game. Versions of the same game
+// share the chunks they have in common, so keeping one costs about what
+// changed since the last, and copying one is a cheap way to fork the game.
+struct BoardVersion
+{
+    BoardHeader header = {};
+    TileChunks mineStates;
+    TileChunks neighborCounts;
+
+    size_t BytesNotSharedWith(BoardVersion const& other) const
+    {
+        return sizeof(BoardVersion) + mineStates.BytesNotSharedWith(other.mineStates) + neighborCounts.BytesNotSharedWith(other.neighborCounts);
+    }
+};
@@ -1,4 +1,5 @@
 #include "pch.h"
+#include "TileArt.h"
 #include "CompAssets.h"
 
 using namespace winrt;
@@ -21,6 +22,11 @@ CompositionSpriteShape GetDotShape(
     return shape;
 }
 
+CompositionColorBrush CreateTileBrush(Compositor const& compositor, TileColor const& color)
+{
+    return compositor.CreateColorBrush(Color{ 255, color.r, color.g, color.b });
+}
+
 CompAssets::CompAssets(
     Compositor const& compositor,
     float2 const& tileSize)
@@ -47,129 +53,31 @@ void CompAssets::GenerateAssets(
     Compositor const& compositor,
     float2 const& tileSize)
 {
-    m_mineBrush = compositor.CreateColorBrush(Colors::Red());
+    m_mineBrush = CreateTileBrush(compositor, MineColor);
 
     m_mineStateBrushes.clear();
-    m_mineStateBrushes.insert({ MineState::Empty, compositor.CreateColorBrush(Colors::Blue()) });
-    m_mineStateBrushes.insert({ MineState::Flag, compositor.CreateColorBrush(Colors::Orange()) });
-    m_mineStateBrushes.insert({ MineState::Question, compositor.CreateColorBrush(Colors::LimeGreen()) });
+    for (auto state : { MineState::Empty, MineState::Flag, MineState::Question })
+    {
+        m_mineStateBrushes.insert({ state, CreateTileBrush(compositor, GetMineStateColor(state)) });
+    }
 
     m_mineCountBackgroundBrushes.clear();
-    m_mineCountBackgroundBrushes.insert({ 1, compositor.CreateColorBrush(Colors::LightBlue()) });
-    m_mineCountBackgroundBrushes.insert({ 2, compositor.CreateColorBrush(Colors::LightGreen()) });
-    m_mineCountBackgroundBrushes.insert({ 3, compositor.CreateColorBrush(Colors::LightSalmon()) });
-    m_mineCountBackgroundBrushes.insert({ 4, compositor.CreateColorBrush(Colors::LightSteelBlue()) });
-    m_mineCountBackgroundBrushes.insert({ 5, compositor.CreateColorBrush(Colors::MediumPurple()) });
-    m_mineCountBackgroundBrushes.insert({ 6, compositor.CreateColorBrush(Colors::LightCyan()) });
-    m_mineCountBackgroundBrushes.insert({ 7, compositor.CreateColorBrush(Colors::Maroon()) });
-    m_mineCountBackgroundBrushes.insert({ 8, compositor.CreateColorBrush(Colors::DarkSeaGreen()) });
-    m_mineCountBackgroundBrushes.insert({ 0, compositor.CreateColorBrush(Colors::WhiteSmoke()) });
+    for (auto count = 0; count <= 8; count++)
+    {
+        m_mineCountBackgroundBrushes.insert({ count, CreateTileBrush(compositor, GetMineCountColor(count)) });
+    }
 
     m_mineCountShapes.clear();
+    auto circleGeometry = compositor.CreateEllipseGeometry();
+    circleGeometry.Radius(tileSize * TileDotRadius);
+    auto dotBrush = CreateTileBrush(compositor, DotColor);
+    for (auto count = 1; count <= 8; count++)
     {
-        auto circleGeometry = compositor.CreateEllipseGeometry();
-        circleGeometry.Radius(tileSize / 12.0f);
-        auto dotBrush = compositor.CreateColorBrush(Colors::Black());
-
-        // 1
-        {
-            auto containerShape = compositor.CreateContainerShape();
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, tileSize / 2.0f));
-            m_mineCountShapes.insert({ 1, containerShape });
-        }
-
-        // 2
-        {
-            auto containerShape = compositor.CreateContainerShape();
-            auto thirdX = tileSize.x / 3.0f;
-            auto halfY = tileSize.y / 2.0f;
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { thirdX , halfY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { thirdX * 2.0f , halfY }));
-            m_mineCountShapes.insert({ 2, containerShape });
-        }
-
-        // 3
-        {
-            auto containerShape = compositor.CreateContainerShape();
-            auto fourthX = tileSize.x / 4.0f;
-            auto fourthY = tileSize.y / 4.0f;
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, tileSize / 2.0f));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY * 3.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY }));
-            m_mineCountShapes.insert({ 3, containerShape });
-        }
-
-
-        // 4
-        {
-            auto containerShape = compositor.CreateContainerShape();
-            auto thirdX = tileSize.x / 3.0f;
-            auto thirdY = tileSize.y / 3.0f;
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { thirdX , thirdY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { thirdX * 2.0f , thirdY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { thirdX , thirdY * 2.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { thirdX * 2.0f , thirdY * 2.0f }));
-            m_mineCountShapes.insert({ 4, containerShape });
-        }
-
-        // 5
-        {
-            auto containerShape = compositor.CreateContainerShape();
-            auto fourthX = tileSize.x / 4.0f;
-            auto fourthY = tileSize.y / 4.0f;
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, tileSize / 2.0f));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY * 3.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY * 3.0f }));
-            m_mineCountShapes.insert({ 5, containerShape });
-        }
-
-        // 6
-        {
-            auto containerShape = compositor.CreateContainerShape();
-            auto fourthX = tileSize.x / 4.0f;
-            auto fourthY = tileSize.y / 4.0f;
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY * 2.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY * 3.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY * 3.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY * 2.0f }));
-            m_mineCountShapes.insert({ 6, containerShape });
-        }
-
-        // 7
-        {
-            auto containerShape = compositor.CreateContainerShape();
-            auto fourthX = tileSize.x / 4.0f;
-            auto fourthY = tileSize.y / 4.0f;
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY * 2.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY * 3.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY * 3.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY * 2.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, tileSize / 2.0f));
-            m_mineCountShapes.insert({ 7, containerShape });
-        }
-
-        // 8
+        auto containerShape = compositor.CreateContainerShape();
+        for (auto& dot : GetMineCountDots(count))
         {
-            auto containerShape = compositor.CreateContainerShape();
-            auto fourthX = tileSize.x / 4.0f;
-            auto fourthY = tileSize.y / 4.0f;
-            auto halfX = tileSize.y / 2.0f;
-            auto thirdY = tileSize.y / 3.0f;
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY * 2.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY * 3.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX, fourthY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY * 3.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { fourthX * 3.0f, fourthY * 2.0f }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { halfX, thirdY }));
-            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, { halfX, thirdY * 2.0f }));
-            m_mineCountShapes.insert({ 8, containerShape });
+            containerShape.Shapes().Append(GetDotShape(compositor, circleGeometry, dotBrush, tileSize * float2(dot.x, dot.y)));
         }
+        m_mineCountShapes.insert({ count, containerShape });
     }
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "pch.h"
 #include "VisualGrid.h"
 #include "CompAssets.h"
+#include "MineTimeline.h"
+#include "TileArt.h"
+#include "TileUpdates.h"
+#include "SoftwareRenderer.h"
 #include "CompUI.h"
 
 using namespace winrt;
@@ -11,6 +15,16 @@ using namespace Windows::Graphics;
 using namespace Windows::UI;
 using namespace Windows::UI::Composition;
 
+namespace
+{
+    // The counts come last in the atlas, so every look past a revealed zero
+    // has dots.
+    bool HasDots(uint8_t look)
+    {
+        return look > TileAtlas::LookFor(MineState::Revealed, 0);
+    }
+}
+
 CompUI::CompUI(
     ContainerVisual const& parentVisual,
     float2 const& parentSize,
@@ -91,8 +105,7 @@ float CompUI::ComputeScaleFactor(float2 windowSize)
 
 void CompUI::UpdateTileWithState(TileCoordinate const& tileCoordinate, MineState mineState)
 {
-    auto visual = m_gameBoard->GetTile(tileCoordinate.x, tileCoordinate.y);
-    visual.Brush(m_assets->GetColorBrushFromMineState(mineState));
+    SetTileLook(m_indexHelper->ComputeIndex(tileCoordinate.x, tileCoordinate.y), mineState, 0);
 }
 
 void CompUI::Reset(SizeInt32 const& gridSizeInTiles)
@@ -104,85 +117,110 @@ void CompUI::Reset(SizeInt32 const& gridSizeInTiles)
     {
         visual.Brush(m_assets->GetColorBrushFromMineState(MineState::Empty));
     }
+    // The grid made new visuals, none of which have dots yet.
+    m_looks.assign(m_gameBoard->Tiles().size(), TileAtlas::LookFor(MineState::Empty, 0));
+    m_countVisuals.assign(m_gameBoard->Tiles().size(), nullptr);
 
     UpdateBoardScale(m_parentSize);
-    m_mineAnimationPlaying = false;
 }
 
 void CompUI::UpdateTileAsMine(TileCoordinate const& tileCoordinate)
 {
-    auto visual = m_gameBoard->GetTile(tileCoordinate.x, tileCoordinate.y);
-    visual.Brush(m_assets->GetMineBrush());
+    SetTileLook(m_indexHelper->ComputeIndex(tileCoordinate.x, tileCoordinate.y), MineState::Revealed, -1);
 }
 
 void CompUI::UpdateTileWithMineCount(TileCoordinate const& tileCoordinate, int numMines)
 {
-    auto visual = m_gameBoard->GetTile(tileCoordinate.x, tileCoordinate.y);
-    visual.Brush(m_assets->GetColorBrushFromMineCount(numMines));
+    SetTileLook(m_indexHelper->ComputeIndex(tileCoordinate.x, tileCoordinate.y), MineState::Revealed, static_cast<int8_t>(numMines));
+}
 
-    if (numMines > 0)
+void CompUI::ApplyTileUpdates(TileUpdate const* updates, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
     {
-        auto shape = m_assets->GetShapeFromMineCount(numMines);
-        auto shapeVisual = m_compositor.CreateShapeVisual();
-        shapeVisual.RelativeSizeAdjustment({ 1, 1 });
-        shapeVisual.Shapes().Append(shape);
-        shapeVisual.BorderMode(CompositionBorderMode::Soft);
-        visual.Children().InsertAtTop(shapeVisual);
+        SetTileLook(updates[i].index, updates[i].state, updates[i].count);
     }
 }
 
-void CompUI::PlayMineAnimations(std::queue<int> mineIndices, std::queue<int> minesPerRing)
+void CompUI::UpdateTilesAsMines(std::vector<int> const& mineIndices)
 {
-    // Create an animation batch so that we can know when the animations complete.
-    auto batch = m_compositor.CreateScopedBatch(CompositionBatchTypes::Animation);
-
-    // Iterate and animate each mine
-    auto animationDelayStep = std::chrono::milliseconds(100);
-    auto currentDelay = std::chrono::milliseconds(0);
-    auto currentMinesCount = 0;
-    while (!mineIndices.empty())
+    for (auto index : mineIndices)
     {
-        auto mineIndex = mineIndices.front();
-        PlayMineAnimation(mineIndex, currentDelay);
-        currentMinesCount++;
+        UpdateTileAsMine({ m_indexHelper->ComputeXFromIndex(index), m_indexHelper->ComputeYFromIndex(index) });
+    }
+}
 
-        auto minesOnCurrentLevel = minesPerRing.front();
-        if (currentMinesCount == minesOnCurrentLevel)
+void CompUI::ApplyMineFrame(std::vector<int> const& mineIndices, std::vector<MineRingFrame> const& frame)
+{
+    for (auto& ring : frame)
+    {
+        for (auto i = ring.firstMine; i < ring.firstMine + ring.mineCount; i++)
         {
-            currentMinesCount = 0;
-            minesPerRing.pop();
-            currentDelay += animationDelayStep;
+            auto index = mineIndices[i];
+            auto visual = m_gameBoard->GetTile(m_indexHelper->ComputeXFromIndex(index), m_indexHelper->ComputeYFromIndex(index));
+            if (ring.started)
+            {
+                // Promote the visual to the top so it grows over its neighbors.
+                auto parentChildren = visual.Parent().Children();
+                parentChildren.Remove(visual);
+                parentChildren.InsertAtTop(visual);
+            }
+            visual.Scale({ ring.scale, ring.scale, 1.0f });
         }
-        mineIndices.pop();
     }
+}
 
-    // Subscribe to the completion event and complete the batch
-    batch.Completed([=](auto&, auto&)
+void CompUI::SetTileLook(int index, MineState state, int8_t count)
+{
+    // Tiles that already look right, like the covered ones when a whole
+    // board is resent after Reset, never get as far as a composition call.
+    auto look = TileAtlas::LookFor(state, count);
+    auto oldLook = m_looks[index];
+    if (look == oldLook)
     {
-        m_mineAnimationPlaying = false;
-    });
-    batch.End();
+        return;
+    }
+    m_looks[index] = look;
 
-    m_mineAnimationPlaying = true;
-}
+    auto& visual = m_gameBoard->Tiles()[index];
+    if (state != MineState::Revealed)
+    {
+        visual.Brush(m_assets->GetColorBrushFromMineState(state));
+    }
+    else if (count < 0)
+    {
+        visual.Brush(m_assets->GetMineBrush());
+    }
+    else
+    {
+        visual.Brush(m_assets->GetColorBrushFromMineCount(count));
+    }
 
-void CompUI::PlayMineAnimation(int index, TimeSpan const& delay)
-{
-    auto visual = m_gameBoard->GetTile(m_indexHelper->ComputeXFromIndex(index), m_indexHelper->ComputeYFromIndex(index));
-    // First, we need to promote the visual to the top.
-    auto parentChildren = visual.Parent().Children();
-    parentChildren.Remove(visual);
-    parentChildren.InsertAtTop(visual);
-    // Make sure the visual has the mine brush
-    visual.Brush(m_assets->GetMineBrush());
-    // Play the animation
-    auto animation = m_compositor.CreateVector3KeyFrameAnimation();
-    animation.InsertKeyFrame(0.0f, { 1.0f, 1.0f, 1.0f });
-    animation.InsertKeyFrame(0.7f, { 2.0f, 2.0f, 1.0f });
-    animation.InsertKeyFrame(1.0f, { 1.0f, 1.0f, 1.0f });
-    animation.Duration(std::chrono::milliseconds(600));
-    animation.DelayTime(delay);
-    animation.IterationBehavior(AnimationIterationBehavior::Count);
-    animation.IterationCount(1);
-    visual.StartAnimation(L"Scale", animation);
+    // A tile keeps the visual for its dots once it has one. Covering it again
+    // only hides it, and revealing it again only swaps in the new count's shape.
+    auto& countVisual = m_countVisuals[index];
+    if (HasDots(look))
+    {
+        auto shape = m_assets->GetShapeFromMineCount(count);
+        if (!countVisual)
+        {
+            countVisual = m_compositor.CreateShapeVisual();
+            countVisual.RelativeSizeAdjustment({ 1, 1 });
+            countVisual.Shapes().Append(shape);
+            countVisual.BorderMode(CompositionBorderMode::Soft);
+            visual.Children().InsertAtTop(countVisual);
+        }
+        else
+        {
+            countVisual.Shapes().SetAt(0, shape);
+            if (!HasDots(oldLook))
+            {
+                countVisual.IsVisible(true);
+            }
+        }
+    }
+    else if (HasDots(oldLook))
+    {
+        countVisual.IsVisible(false);
+    }
 }
\ No newline at end of file
@@ -2,16 +2,17 @@
 
 class CompAssets;
 class VisualGrid;
+struct MineRingFrame;
 struct TileCoordinate;
 
-class CompUI
+class CompUI : public TileUpdateSink
 {
 public:
     CompUI(
         winrt::Windows::UI::Composition::ContainerVisual const& parentVisual,
         winrt::Windows::Foundation::Numerics::float2 const& parentSize,
         winrt::Windows::Graphics::SizeInt32 const& gridSizeInTiles);
-    ~CompUI() {}
+    ~CompUI() override {}
 
     void Resize(winrt::Windows::Foundation::Numerics::float2 const& newSize);
     std::optional<TileCoordinate> HitTest(winrt::Windows::Foundation::Numerics::float2 const& point);
@@ -21,14 +22,17 @@ public:
     void Reset(winrt::Windows::Graphics::SizeInt32 const& gridSizeInTiles);
     void UpdateTileAsMine(TileCoordinate const& tileCoordinate);
     void UpdateTileWithMineCount(TileCoordinate const& tileCoordinate, int numMines);
-    void PlayMineAnimations(std::queue<int> mineIndices, std::queue<int> minesPerRing);
-    bool IsAnimationPlaying() { return m_mineAnimationPlaying; }
+    void ApplyTileUpdates(TileUpdate const* updates, size_t count) override;
+    void UpdateTilesAsMines(std::vector<int> const& mineIndices);
+    // Scales the mines of each ring in frame, see MineTimeline.
+    void ApplyMineFrame(std::vector<int> const& mineIndices, std::vector<MineRingFrame> const& frame);
 
 private:
     float ComputeScaleFactor(winrt::Windows::Foundation::Numerics::float2 windowSize);
     float ComputeScaleFactor();
     void UpdateBoardScale(winrt::Windows::Foundation::Numerics::float2 windowSize);
-    void PlayMineAnimation(int index, winrt::Windows::Foundation::TimeSpan const& delay);
+    // Only touches the tile's visuals when its look changes.
+    void SetTileLook(int index, MineState state, int8_t count);
 
 private:
     winrt::Windows::UI::Composition::Compositor m_compositor{ nullptr };
@@ -41,5 +45,8 @@ private:
     std::unique_ptr<VisualGrid> m_gameBoard;
     std::unique_ptr<CompAssets> m_assets;
 
-    bool m_mineAnimationPlaying = false;
+    // What each tile shows, as TileAtlas looks, and the visual for its dots
+    // if it has ever shown any.
+    std::vector<uint8_t> m_looks;
+    std::vector<winrt::Windows::UI::Composition::ShapeVisual> m_countVisuals;
 };
\ No newline at end of file
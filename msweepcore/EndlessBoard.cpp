@@ -0,0 +1,191 @@
+#include "pch.h"
+#include "EndlessBoard.h"
+
+namespace
+{
+    inline uint64_t Mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    // Counter based hash of a tile, the same coordinates always give the same value.
+    inline uint64_t HashTile(uint64_t seed, int64_t x, int64_t y)
+    {
+        auto value = Mix(seed ^ (static_cast<uint64_t>(x) * 0x9e3779b97f4a7c15ull));
+        return Mix(value ^ (static_cast<uint64_t>(y) * 0xc2b2ae3d27d4eb4full));
+    }
+}
+
+size_t EndlessBoard::ChunkKeyHash::operator()(ChunkKey const& key) const
+{
+    return static_cast<size_t>(HashTile(0, key.x, key.y));
+}
+
+EndlessBoard::EndlessBoard(uint64_t seed, double mineDensity)
+{
+    m_seed = seed;
+    mineDensity = std::clamp(mineDensity, 0.0, 1.0);
+    m_mineThreshold = mineDensity >= 1.0 ? UINT64_MAX : static_cast<uint64_t>(mineDensity * 18446744073709551616.0);
+}
+
+bool EndlessBoard::IsMine(int64_t x, int64_t y) const
+{
+    // Keep the tiles around the origin clear so the first sweep always opens up.
+    if (x >= -1 && x <= 1 && y >= -1 && y <= 1)
+    {
+        return false;
+    }
+    return HashTile(m_seed, x, y) < m_mineThreshold;
+}
+
+int EndlessBoard::GetSurroundingMineCount(int64_t x, int64_t y) const
+{
+    auto count = 0;
+    for (auto offsetX = -1; offsetX <= 1; offsetX++)
+    {
+        for (auto offsetY = -1; offsetY <= 1; offsetY++)
+        {
+            if ((offsetX != 0 || offsetY != 0) && IsMine(x + offsetX, y + offsetY))
+            {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+MineState EndlessBoard::GetState(int64_t x, int64_t y) const
+{
+    auto chunk = m_chunks.find(ChunkKeyFromTile(x, y));
+    if (chunk == m_chunks.end())
+    {
+        return MineState::Empty;
+    }
+    return chunk->second->states[LocalIndex(x, y)];
+}
+
+MineState EndlessBoard::CycleState(int64_t x, int64_t y)
+{
+    auto& state = GetOrCreateChunk(x, y).states[LocalIndex(x, y)];
+    switch (state)
+    {
+    case MineState::Empty:
+        state = MineState::Flag;
+        break;
+    case MineState::Flag:
+        state = MineState::Question;
+        break;
+    case MineState::Question:
+        state = MineState::Empty;
+        break;
+    case MineState::Revealed:
+        break;
+    }
+    return state;
+}
+
+bool EndlessBoard::Sweep(int64_t x, int64_t y, std::vector<EndlessTileCoordinate>& revealedTiles, size_t maxTiles)
+{
+    auto& chunk = GetOrCreateChunk(x, y);
+    auto localIndex = LocalIndex(x, y);
+    if (chunk.states[localIndex] != MineState::Empty)
+    {
+        return false;
+    }
+
+    RevealTile(chunk, localIndex, x, y, revealedTiles);
+    if (chunk.neighborCounts[localIndex] < 0)
+    {
+        return true;
+    }
+
+    ContinueSweep(revealedTiles, maxTiles);
+    return false;
+}
+
+void EndlessBoard::ContinueSweep(std::vector<EndlessTileCoordinate>& revealedTiles, size_t maxTiles)
+{
+    auto limit = revealedTiles.size() + maxTiles;
+    while (!m_frontier.empty() && revealedTiles.size() < limit)
+    {
+        auto tile = m_frontier.back();
+        m_frontier.pop_back();
+
+        for (auto offsetX = -1; offsetX <= 1; offsetX++)
+        {
+            for (auto offsetY = -1; offsetY <= 1; offsetY++)
+            {
+                auto x = tile.x + offsetX;
+                auto y = tile.y + offsetY;
+                auto& chunk = GetOrCreateChunk(x, y);
+                auto localIndex = LocalIndex(x, y);
+                if (chunk.states[localIndex] == MineState::Empty)
+                {
+                    RevealTile(chunk, localIndex, x, y, revealedTiles);
+                }
+            }
+        }
+    }
+}
+
+EndlessBoard::Chunk& EndlessBoard::GetOrCreateChunk(int64_t x, int64_t y)
+{
+    auto key = ChunkKeyFromTile(x, y);
+    if (m_lastChunk != nullptr && key == m_lastChunkKey)
+    {
+        return *m_lastChunk;
+    }
+
+    auto& chunk = m_chunks[key];
+    if (!chunk)
+    {
+        chunk = std::make_unique<Chunk>();
+        chunk->states.fill(MineState::Empty);
+
+        // Hash the chunk plus a one tile border once, then count from that.
+        const int paddedSize = ChunkSize + 2;
+        std::array<bool, paddedSize * paddedSize> mines;
+        auto originX = key.x << ChunkShift;
+        auto originY = key.y << ChunkShift;
+        for (auto localX = 0; localX < paddedSize; localX++)
+        {
+            for (auto localY = 0; localY < paddedSize; localY++)
+            {
+                mines[localX * paddedSize + localY] = IsMine(originX + localX - 1, originY + localY - 1);
+            }
+        }
+
+        for (auto localX = 0; localX < ChunkSize; localX++)
+        {
+            for (auto localY = 0; localY < ChunkSize; localY++)
+            {
+                auto center = (localX + 1) * paddedSize + (localY + 1);
+                int8_t count = -1;
+                if (!mines[center])
+                {
+                    count = static_cast<int8_t>(
+                        mines[center - paddedSize - 1] + mines[center - paddedSize] + mines[center - paddedSize + 1] +
+                        mines[center - 1] + mines[center + 1] +
+                        mines[center + paddedSize - 1] + mines[center + paddedSize] + mines[center + paddedSize + 1]);
+                }
+                chunk->neighborCounts[(localX << ChunkShift) | localY] = count;
+            }
+        }
+    }
+
+    m_lastChunkKey = key;
+    m_lastChunk = chunk.get();
+    return *chunk;
+}
+
+void EndlessBoard::RevealTile(Chunk& chunk, int localIndex, int64_t x, int64_t y, std::vector<EndlessTileCoordinate>& revealedTiles)
+{
+    chunk.states[localIndex] = MineState::Revealed;
+    revealedTiles.push_back({ x, y });
+    if (chunk.neighborCounts[localIndex] == 0)
+    {
+        m_frontier.push_back({ x, y });
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+struct EndlessTileCoordinate
+{
+    int64_t x;
+    int64_t y;
+};
+
+// A board with no edges. Whether a tile is a mine is a pure function of the
+// seed and its coordinates, so the mine layout takes no memory at all. Tile
+// state lives in fixed size chunks that are only allocated once a sweep or a
+// mark reaches them, so memory grows with the explored area.
+class EndlessBoard
+{
+public:
+    static const int ChunkShift = 5;
+    static const int ChunkSize = 1 << ChunkShift;
+
+    EndlessBoard(uint64_t seed, double mineDensity);
+    ~EndlessBoard() {}
+
+    uint64_t Seed() const { return m_seed; }
+    bool IsMine(int64_t x, int64_t y) const;
+    int GetSurroundingMineCount(int64_t x, int64_t y) const;
+    MineState GetState(int64_t x, int64_t y) const;
+    MineState CycleState(int64_t x, int64_t y);
+    size_t ChunkCount() const { return m_chunks.size(); }
+
+    // Reveals (x, y) and, if it has no surrounding mines, the opening around
+    // it. Openings on sparse boards can be arbitrarily large, so a call stops
+    // once about maxTiles tiles have been revealed and keeps the rest of the
+    // frontier for ContinueSweep. Returns true if (x, y) is a mine.
+    bool Sweep(int64_t x, int64_t y, std::vector<EndlessTileCoordinate>& revealedTiles, size_t maxTiles);
+    bool HasPendingSweep() const { return !m_frontier.empty(); }
+    void ContinueSweep(std::vector<EndlessTileCoordinate>& revealedTiles, size_t maxTiles);
+
+private:
+    struct ChunkKey
+    {
+        int64_t x;
+        int64_t y;
+
+        bool operator==(ChunkKey const& other) const { return x == other.x && y == other.y; }
+    };
+
+    struct ChunkKeyHash
+    {
+        size_t operator()(ChunkKey const& key) const;
+    };
+
+    struct Chunk
+    {
+        std::array<MineState, ChunkSize * ChunkSize> states;
+        // -1 means a mine
+        std::array<int8_t, ChunkSize * ChunkSize> neighborCounts;
+    };
+
+    static ChunkKey ChunkKeyFromTile(int64_t x, int64_t y) { return { x >> ChunkShift, y >> ChunkShift }; }
+    static int LocalIndex(int64_t x, int64_t y) { return static_cast<int>(((x & (ChunkSize - 1)) << ChunkShift) | (y & (ChunkSize - 1))); }
+    Chunk& GetOrCreateChunk(int64_t x, int64_t y);
+    void RevealTile(Chunk& chunk, int localIndex, int64_t x, int64_t y, std::vector<EndlessTileCoordinate>& revealedTiles);
+
+private:
+    uint64_t m_seed;
+    uint64_t m_mineThreshold;
+    std::unordered_map<ChunkKey, std::unique_ptr<Chunk>, ChunkKeyHash> m_chunks;
+    // The last chunk looked up, sweeps mostly stay inside one chunk at a time.
+    ChunkKey m_lastChunkKey = { 0, 0 };
+    Chunk* m_lastChunk = nullptr;
+    std::vector<EndlessTileCoordinate> m_frontier;
+};
@@ -0,0 +1,354 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "HostProtocol.h"
+#include "GameHost.h"
+
+// How long a busy worker goes before picking up new connections. An idle
+// worker waits on its condition variable instead and wakes right away.
+static const int PollTimeoutMilliseconds = 10;
+static const size_t ReceiveSize = 16 * 1024;
+
+HostSession::HostSession(uint64_t id)
+{
+    m_id = id;
+    // Thousands of sessions can be open at once, a pool each would be
+    // thousands of threads per core. The host's workers are the parallelism.
+    m_game.SetParallelSweep(false);
+    m_game.SetTileUpdateSink(this);
+}
+
+size_t HostSession::HandleRequests(uint8_t const* input, size_t size, std::vector<uint8_t>& output)
+{
+    size_t used = 0;
+    HostFrame frame = {};
+    while (ReadHostFrame(input + used, size - used, frame))
+    {
+        if (!HandleRequest(frame, output))
+        {
+            EndHostFrame(output, BeginHostFrame(output, HostMessageKind::Error));
+        }
+        used += frame.frameSize;
+    }
+    return used;
+}
+
+bool HostSession::HandleRequest(HostFrame const& frame, std::vector<uint8_t>& output)
+{
+    switch (frame.kind)
+    {
+    case HostMessageKind::NewGame:
+    {
+        if (frame.payloadSize != sizeof(int16_t) * 2 + sizeof(int32_t) + sizeof(uint64_t))
+        {
+            return false;
+        }
+        auto width = ReadHostValue<int16_t>(frame.payload);
+        auto height = ReadHostValue<int16_t>(frame.payload + 2);
+        auto mines = ReadHostValue<int32_t>(frame.payload + 4);
+        auto seed = ReadHostValue<uint64_t>(frame.payload + 8);
+        if (width <= 0 || height <= 0 || width > MaximumSide || height > MaximumSide || mines < 0)
+        {
+            return false;
+        }
+
+        m_game.NewGame(width, height, mines, seed);
+        m_hasGame = true;
+        EndHostFrame(output, BeginHostFrame(output, frame.kind));
+        return true;
+    }
+    case HostMessageKind::Sweep:
+    case HostMessageKind::Flag:
+    {
+        if (!m_hasGame || frame.payloadSize != sizeof(uint16_t) * 2)
+        {
+            return false;
+        }
+        auto x = ReadHostValue<uint16_t>(frame.payload);
+        auto y = ReadHostValue<uint16_t>(frame.payload + 2);
+
+        // The tiles are appended by ApplyTileUpdates while the press runs,
+        // the fields in front of them are filled in after.
+        auto frameStart = BeginHostFrame(output, frame.kind);
+        auto fieldsStart = output.size();
+        output.resize(fieldsStart + sizeof(uint8_t) + sizeof(int32_t) + sizeof(uint32_t));
+        m_response = &output;
+        m_responseTiles = 0;
+        auto result = m_game.Press(x, y, frame.kind == HostMessageKind::Flag);
+        m_response = nullptr;
+
+        auto fields = output.data() + fieldsStart;
+        fields[0] = static_cast<uint8_t>(result);
+        auto unrevealedTiles = m_game.Header().unrevealedTiles;
+        std::memcpy(fields + 1, &unrevealedTiles, sizeof(unrevealedTiles));
+        std::memcpy(fields + 5, &m_responseTiles, sizeof(m_responseTiles));
+        EndHostFrame(output, frameStart);
+        return true;
+    }
+    case HostMessageKind::Snapshot:
+    {
+        if (!m_hasGame || frame.payloadSize != 0)
+        {
+            return false;
+        }
+
+        m_game.SaveSnapshot(m_snapshot);
+        auto frameStart = BeginHostFrame(output, frame.kind);
+        output.insert(output.end(), m_snapshot.begin(), m_snapshot.end());
+        EndHostFrame(output, frameStart);
+        return true;
+    }
+    }
+    return false;
+}
+
+void HostSession::ApplyTileUpdates(TileUpdate const* updates, size_t count)
+{
+    if (!m_response)
+    {
+        return;
+    }
+
+    const size_t TileSize = sizeof(int32_t) + sizeof(uint8_t);
+    auto offset = m_response->size();
+    m_response->resize(offset + count * TileSize);
+    auto tile = m_response->data() + offset;
+    for (size_t i = 0; i < count; i++)
+    {
+        std::memcpy(tile, &updates[i].index, sizeof(int32_t));
+        tile[sizeof(int32_t)] = EncodeTileLook(updates[i].state, updates[i].count);
+        tile += TileSize;
+    }
+    m_responseTiles += static_cast<uint32_t>(count);
+}
+
+GameHost::GameHost(uint16_t port, int workerCount)
+{
+    WSADATA data = {};
+    auto startupError = WSAStartup(MAKEWORD(2, 2), &data);
+    if (startupError != 0)
+    {
+        winrt::throw_hresult(HRESULT_FROM_WIN32(startupError));
+    }
+
+    // Only this machine can connect.
+    m_listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    auto addressSize = static_cast<int>(sizeof(address));
+    if (m_listener == INVALID_SOCKET ||
+        bind(m_listener, reinterpret_cast<sockaddr*>(&address), addressSize) == SOCKET_ERROR ||
+        listen(m_listener, SOMAXCONN) == SOCKET_ERROR ||
+        getsockname(m_listener, reinterpret_cast<sockaddr*>(&address), &addressSize) == SOCKET_ERROR)
+    {
+        auto error = WSAGetLastError();
+        if (m_listener != INVALID_SOCKET)
+        {
+            closesocket(m_listener);
+        }
+        WSACleanup();
+        winrt::throw_hresult(HRESULT_FROM_WIN32(error));
+    }
+    m_port = ntohs(address.sin_port);
+
+    if (workerCount <= 0)
+    {
+        workerCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (auto i = 0; i < workerCount; i++)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : m_workers)
+    {
+        worker->thread = std::thread(&GameHost::Serve, this, std::ref(*worker));
+    }
+    m_acceptThread = std::thread(&GameHost::Accept, this);
+}
+
+GameHost::~GameHost()
+{
+    m_stopping = true;
+    // Closing the listener is what gets accept to return.
+    shutdown(m_listener, SD_BOTH);
+    closesocket(m_listener);
+    m_acceptThread.join();
+    for (auto& worker : m_workers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker->lock);
+            worker->condition.notify_one();
+        }
+        worker->thread.join();
+    }
+    WSACleanup();
+}
+
+size_t GameHost::ActiveSessions() const
+{
+    size_t sessions = 0;
+    for (auto& worker : m_workers)
+    {
+        sessions += worker->activeSessions;
+    }
+    return sessions;
+}
+
+void GameHost::Accept()
+{
+    while (!m_stopping)
+    {
+        auto socket = accept(m_listener, nullptr, nullptr);
+        if (socket == INVALID_SOCKET)
+        {
+            continue;
+        }
+
+        // Requests are a few bytes each, don't hold them back to fill a packet.
+        BOOL noDelay = TRUE;
+        u_long nonBlocking = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char const*>(&noDelay), sizeof(noDelay));
+        ioctlsocket(socket, FIONBIO, &nonBlocking);
+
+        Connection connection;
+        connection.socket = socket;
+        connection.session = std::make_unique<HostSession>(m_nextSessionId++);
+        auto& worker = *m_workers[connection.session->Id() % m_workers.size()];
+        worker.activeSessions++;
+        {
+            std::lock_guard<std::mutex> lock(worker.lock);
+            worker.incoming.push_back(std::move(connection));
+        }
+        worker.condition.notify_one();
+    }
+}
+
+void GameHost::Serve(Worker& worker)
+{
+    std::vector<Connection> connections;
+    std::vector<WSAPOLLFD> polls;
+    while (!m_stopping)
+    {
+        {
+            std::unique_lock<std::mutex> lock(worker.lock);
+            if (connections.empty())
+            {
+                worker.condition.wait(lock, [&]() { return m_stopping || !worker.incoming.empty(); });
+            }
+            for (auto& connection : worker.incoming)
+            {
+                connections.push_back(std::move(connection));
+            }
+            worker.incoming.clear();
+        }
+        if (connections.empty())
+        {
+            continue;
+        }
+
+        // A connection isn't read from while it still has responses to send,
+        // so a client that doesn't read can't make the host buffer forever.
+        polls.resize(connections.size());
+        for (size_t i = 0; i < connections.size(); i++)
+        {
+            polls[i].fd = connections[i].socket;
+            polls[i].events = connections[i].output.empty() ? POLLRDNORM : POLLWRNORM;
+            polls[i].revents = 0;
+        }
+        if (WSAPoll(polls.data(), static_cast<ULONG>(polls.size()), PollTimeoutMilliseconds) <= 0)
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i < connections.size();)
+        {
+            auto& connection = connections[i];
+            auto events = polls[i].revents;
+            auto open = (events & (POLLERR | POLLNVAL)) == 0;
+            if (open && (events & (POLLRDNORM | POLLHUP)))
+            {
+                open = Receive(connection);
+            }
+            else if (open && (events & POLLWRNORM))
+            {
+                open = Flush(connection);
+            }
+
+            if (open)
+            {
+                i++;
+                continue;
+            }
+
+            closesocket(connection.socket);
+            worker.activeSessions--;
+            // Keep the poll results lined up with the connections.
+            if (i + 1 < connections.size())
+            {
+                connection = std::move(connections.back());
+                polls[i] = polls[connections.size() - 1];
+            }
+            connections.pop_back();
+        }
+    }
+
+    for (auto& connection : connections)
+    {
+        closesocket(connection.socket);
+        worker.activeSessions--;
+    }
+}
+
+bool GameHost::Receive(Connection& connection)
+{
+    auto offset = connection.input.size();
+    connection.input.resize(offset + ReceiveSize);
+    auto received = recv(connection.socket, reinterpret_cast<char*>(connection.input.data() + offset), static_cast<int>(ReceiveSize), 0);
+    if (received <= 0)
+    {
+        connection.input.resize(offset);
+        // Zero means the client hung up.
+        return received < 0 && WSAGetLastError() == WSAEWOULDBLOCK;
+    }
+    connection.input.resize(offset + received);
+
+    try
+    {
+        auto used = connection.session->HandleRequests(connection.input.data(), connection.input.size(), connection.output);
+        connection.input.erase(connection.input.begin(), connection.input.begin() + used);
+    }
+    catch (...)
+    {
+        return false;
+    }
+    return Flush(connection);
+}
+
+bool GameHost::Flush(Connection& connection)
+{
+    while (connection.outputSent < connection.output.size())
+    {
+        auto remaining = connection.output.size() - connection.outputSent;
+        auto sent = send(connection.socket, reinterpret_cast<char const*>(connection.output.data() + connection.outputSent), static_cast<int>(std::min<size_t>(remaining, std::numeric_limits<int>::max())), 0);
+        if (sent == SOCKET_ERROR)
+        {
+            // The rest goes out once the socket says it's writable.
+            return WSAGetLastError() == WSAEWOULDBLOCK;
+        }
+        connection.outputSent += sent;
+    }
+    connection.output.clear();
+    connection.outputSent = 0;
+    return true;
+}
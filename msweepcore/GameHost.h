@@ -0,0 +1,89 @@
+#pragma once
+
+// One player's connection to a GameHost, with no UI. A session owns its game
+// and every buffer it needs. The board storage and the batch buffers are
+// reused from game to game, so a player who keeps playing boards no bigger
+// than their first allocates nothing more. Only the worker that owns a
+// session ever touches it, so sessions need no locks.
+class HostSession : public TileUpdateSink
+{
+public:
+    // Keeps every response, snapshots included, well under HostMaximumFrameSize.
+    static const int MaximumSide = 1024;
+
+    HostSession(uint64_t id);
+    ~HostSession() override {}
+
+    uint64_t Id() const { return m_id; }
+
+    // Answers every whole request at the start of input, appending the
+    // responses to output, and returns how many bytes of input were used.
+    // Throws if the stream is broken, the connection should be closed then.
+    size_t HandleRequests(uint8_t const* input, size_t size, std::vector<uint8_t>& output);
+
+    void ApplyTileUpdates(TileUpdate const* updates, size_t count) override;
+
+private:
+    bool HandleRequest(HostFrame const& frame, std::vector<uint8_t>& output);
+
+private:
+    uint64_t m_id;
+    MinesweeperGame m_game;
+    bool m_hasGame = false;
+    std::vector<uint8_t> m_snapshot;
+
+    // Where the press being answered writes its tiles.
+    std::vector<uint8_t>* m_response = nullptr;
+    uint32_t m_responseTiles = 0;
+};
+
+// Serves games over loopback TCP, one session per connection. Sessions are
+// handed to a pool of workers by id, and each worker polls its own
+// connections, so a session's requests are always answered by the same
+// thread in the order they were sent.
+class GameHost
+{
+public:
+    // A port of 0 picks a free one, see Port. A workerCount of 0 uses one
+    // worker per hardware thread.
+    GameHost(uint16_t port = 0, int workerCount = 0);
+    ~GameHost();
+
+    uint16_t Port() const { return m_port; }
+    int WorkerCount() const { return static_cast<int>(m_workers.size()); }
+    uint64_t SessionsStarted() const { return m_nextSessionId; }
+    size_t ActiveSessions() const;
+
+private:
+    struct Connection
+    {
+        SOCKET socket = INVALID_SOCKET;
+        std::unique_ptr<HostSession> session;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputSent = 0;
+    };
+
+    struct Worker
+    {
+        std::mutex lock;
+        std::condition_variable condition;
+        std::vector<Connection> incoming;
+        std::atomic<size_t> activeSessions = 0;
+        std::thread thread;
+    };
+
+    void Accept();
+    void Serve(Worker& worker);
+    // Both return false once the connection should be closed.
+    bool Receive(Connection& connection);
+    bool Flush(Connection& connection);
+
+private:
+    SOCKET m_listener = INVALID_SOCKET;
+    uint16_t m_port = 0;
+    std::atomic<bool> m_stopping = false;
+    std::atomic<uint64_t> m_nextSessionId = 0;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::thread m_acceptThread;
+};
@@ -0,0 +1,375 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+#include "GameLog.h"
+
+namespace
+{
+    struct GameLogHeader
+    {
+        static const uint32_t ExpectedMagic = 0x4c57534d; // "MSWL"
+        static const uint16_t CurrentVersion = 1;
+
+        uint32_t magic;
+        uint16_t version;
+        GameOutcome outcome;
+        uint8_t reserved;
+        int32_t width;
+        int32_t height;
+        int32_t numMines;
+        uint32_t duration;
+        uint64_t seed;
+        uint64_t stateHash;
+        uint32_t eventCount;
+        uint32_t eventsSize;
+    };
+
+    void WriteVarint(std::vector<uint8_t>& output, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            output.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        output.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint64_t ReadVarint(uint8_t const*& data, uint8_t const* end)
+    {
+        uint64_t value = 0;
+        for (auto shift = 0; shift < 64; shift += 7)
+        {
+            if (data == end)
+            {
+                throw std::runtime_error("The game log is truncated!");
+            }
+            auto byte = *data++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        throw std::runtime_error("The game log has a malformed event!");
+    }
+
+    // Anything that passes can be replayed without an unreasonable
+    // allocation, and always leaves a tile free for the first click.
+    bool IsPlayableBoard(int width, int height, int numMines)
+    {
+        if (width <= 0 || height <= 0 || width > GameLogMaximumSide || height > GameLogMaximumSide)
+        {
+            return false;
+        }
+        auto tileCount = static_cast<int64_t>(width) * height;
+        return tileCount <= GameLogMaximumTiles && numMines >= 0 && numMines < tileCount;
+    }
+}
+
+void WriteGameLog(GameLog const& log, std::vector<uint8_t>& output)
+{
+    output.assign(sizeof(GameLogHeader), 0);
+
+    uint32_t time = 0;
+    for (auto& event : log.events)
+    {
+        WriteVarint(output, event.time - time);
+        WriteVarint(output, (static_cast<uint64_t>(event.x) << 2) | static_cast<uint64_t>(event.kind));
+        WriteVarint(output, static_cast<uint32_t>(event.y));
+        time = event.time;
+    }
+
+    GameLogHeader header = {};
+    header.magic = GameLogHeader::ExpectedMagic;
+    header.version = GameLogHeader::CurrentVersion;
+    header.outcome = log.outcome;
+    header.width = log.width;
+    header.height = log.height;
+    header.numMines = log.numMines;
+    header.duration = log.duration;
+    header.seed = log.seed;
+    header.stateHash = log.stateHash;
+    header.eventCount = static_cast<uint32_t>(log.events.size());
+    header.eventsSize = static_cast<uint32_t>(output.size() - sizeof(GameLogHeader));
+    memcpy(output.data(), &header, sizeof(header));
+}
+
+void ReadGameLog(uint8_t const* data, size_t size, GameLog& log)
+{
+    if (size < sizeof(GameLogHeader))
+    {
+        throw std::runtime_error("The game log is too small!");
+    }
+
+    GameLogHeader header = {};
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != GameLogHeader::ExpectedMagic || header.version != GameLogHeader::CurrentVersion)
+    {
+        throw std::runtime_error("The buffer isn't a game log this version understands!");
+    }
+    if (!IsPlayableBoard(header.width, header.height, header.numMines) || header.outcome > GameOutcome::Lost)
+    {
+        throw std::runtime_error("The game log has an invalid header!");
+    }
+    if (size - sizeof(GameLogHeader) < header.eventsSize)
+    {
+        throw std::runtime_error("The game log is truncated!");
+    }
+
+    log.seed = header.seed;
+    log.width = header.width;
+    log.height = header.height;
+    log.numMines = header.numMines;
+    log.outcome = header.outcome;
+    log.duration = header.duration;
+    log.stateHash = header.stateHash;
+
+    // Every event takes at least three bytes, don't trust the count any further than that.
+    log.events.clear();
+    log.events.reserve(std::min<size_t>(header.eventCount, header.eventsSize / 3));
+
+    auto current = data + sizeof(GameLogHeader);
+    auto end = current + header.eventsSize;
+    uint64_t time = 0;
+    for (uint32_t i = 0; i < header.eventCount; i++)
+    {
+        time += ReadVarint(current, end);
+        auto packedX = ReadVarint(current, end);
+        auto y = ReadVarint(current, end);
+
+        auto kind = static_cast<GameLogEventKind>(packedX & 0x3);
+        auto x = packedX >> 2;
+        if (time > std::numeric_limits<uint32_t>::max() ||
+            kind > GameLogEventKind::Mark ||
+            x >= static_cast<uint64_t>(header.width) ||
+            y >= static_cast<uint64_t>(header.height))
+        {
+            throw std::runtime_error("The game log has a malformed event!");
+        }
+
+        log.events.push_back({ static_cast<uint32_t>(time), kind, static_cast<int32_t>(x), static_cast<int32_t>(y) });
+    }
+
+    if (current != end)
+    {
+        throw std::runtime_error("The game log has trailing data!");
+    }
+}
+
+void GameRecorder::Start(BoardHeader const& header)
+{
+    m_recording = true;
+    m_log.seed = header.seed;
+    m_log.width = header.width;
+    m_log.height = header.height;
+    m_log.numMines = header.numMines;
+    m_log.events.clear();
+    m_log.outcome = GameOutcome::Playing;
+    m_log.duration = 0;
+    m_log.stateHash = 0;
+    m_start = std::chrono::steady_clock::now();
+}
+
+void GameRecorder::Record(GameLogEventKind kind, int x, int y)
+{
+    if (!m_recording)
+    {
+        return;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start);
+    m_log.events.push_back({ static_cast<uint32_t>(elapsed.count()), kind, x, y });
+}
+
+GameLog const& GameRecorder::Finish(MinesweeperGame const& game)
+{
+    if (!m_recording)
+    {
+        throw std::runtime_error("This game wasn't recorded from the start!");
+    }
+
+    // No guess games switch to the seed they found on the first sweep.
+    m_log.seed = game.Header().seed;
+    m_log.outcome = game.Header().outcome;
+    m_log.duration = m_log.events.empty() ? 0 : m_log.events.back().time;
+    m_log.stateHash = game.ComputeStateHash();
+    return m_log;
+}
+
+void ReplayGameLog(GameLog const& log, MinesweeperGame& game)
+{
+    game.NewGame(log.width, log.height, log.numMines, log.seed);
+    for (auto& event : log.events)
+    {
+        if (event.kind != GameLogEventKind::Select)
+        {
+            game.Press(event.x, event.y, event.kind == GameLogEventKind::Mark);
+        }
+    }
+}
+
+std::string VerifyGameLog(GameLog const& log, MinesweeperGame& game)
+{
+    if (!IsPlayableBoard(log.width, log.height, log.numMines))
+    {
+        return "The board size or mine count is invalid.";
+    }
+
+    // The same as ReplayGameLog, but checking each event on the way.
+    game.NewGame(log.width, log.height, log.numMines, log.seed);
+    uint32_t time = 0;
+    // The times of the last GameLogMaximumPressesPerSecond presses.
+    std::array<uint32_t, GameLogMaximumPressesPerSecond> pressTimes = {};
+    size_t presses = 0;
+    for (auto& event : log.events)
+    {
+        if (event.time < time)
+        {
+            return "The events are out of order.";
+        }
+        time = event.time;
+
+        if (event.kind != GameLogEventKind::Select)
+        {
+            auto& oldestPressTime = pressTimes[presses % pressTimes.size()];
+            if (presses >= pressTimes.size() && time - oldestPressTime < 1000)
+            {
+                return "The presses are faster than anyone can click.";
+            }
+            oldestPressTime = time;
+            presses++;
+        }
+
+        if (!game.Indices().IsInBounds(event.x, event.y))
+        {
+            return "An event is outside of the board.";
+        }
+        // Input stops being recorded once the game is over.
+        if (game.IsGameOver())
+        {
+            return "There are events after the game ended.";
+        }
+
+        if (event.kind != GameLogEventKind::Select)
+        {
+            game.Press(event.x, event.y, event.kind == GameLogEventKind::Mark);
+        }
+    }
+
+    if (game.Header().outcome != log.outcome)
+    {
+        return "The outcome doesn't match.";
+    }
+    if (log.duration != time)
+    {
+        return "The duration doesn't match the events.";
+    }
+    if (game.ComputeStateHash() != log.stateHash)
+    {
+        return "The final board doesn't match.";
+    }
+    return {};
+}
+
+GameLogBatchResult VerifyGameLogDirectory(std::filesystem::path const& directory, int threadCount)
+{
+    std::vector<std::filesystem::path> paths;
+    for (auto& entry : std::filesystem::directory_iterator(directory))
+    {
+        if (entry.is_regular_file())
+        {
+            paths.push_back(entry.path());
+        }
+    }
+
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    threadCount = static_cast<int>(std::min<size_t>(threadCount, std::max<size_t>(paths.size(), 1)));
+
+    // Logs vary a lot in length, so threads pull the next file as they finish
+    // instead of being handed a fixed share up front.
+    GameLogBatchResult result;
+    std::atomic<size_t> nextPath = 0;
+    std::mutex failuresLock;
+    auto verify = [&]()
+    {
+        MinesweeperGame game;
+        game.SetParallelSweep(false);
+        GameLog log;
+        std::vector<uint8_t> buffer;
+        for (auto i = nextPath++; i < paths.size(); i = nextPath++)
+        {
+            std::string reason;
+            auto corrupt = false;
+            try
+            {
+                auto fileSize = std::filesystem::file_size(paths[i]);
+                if (fileSize > GameLogMaximumFileSize)
+                {
+                    throw std::runtime_error("The game log is too big!");
+                }
+                std::ifstream file(paths[i], std::ios::binary);
+                buffer.resize(static_cast<size_t>(fileSize));
+                if (!file.read(reinterpret_cast<char*>(buffer.data()), buffer.size()))
+                {
+                    throw std::runtime_error("The game log couldn't be read!");
+                }
+                // Rejects boards past the limits before the game allocates them.
+                ReadGameLog(buffer.data(), buffer.size(), log);
+            }
+            catch (std::exception const& error)
+            {
+                reason = error.what();
+                corrupt = true;
+            }
+
+            if (!corrupt)
+            {
+                try
+                {
+                    reason = VerifyGameLog(log, game);
+                }
+                catch (std::exception const& error)
+                {
+                    reason = error.what();
+                }
+            }
+
+            if (!reason.empty())
+            {
+                std::lock_guard<std::mutex> lock(failuresLock);
+                result.failures.push_back({ paths[i], reason });
+                if (corrupt)
+                {
+                    result.corrupt++;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (auto i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(verify);
+    }
+    verify();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::sort(result.failures.begin(), result.failures.end(), [](auto const& left, auto const& right) { return left.path < right.path; });
+    result.checked = paths.size();
+    return result;
+}
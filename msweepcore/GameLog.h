@@ -0,0 +1,108 @@
+#pragma once
+
+enum class GameLogEventKind : uint8_t
+{
+    // The pointer moved onto a tile. Replays skip these, they only carry timing.
+    Select = 0,
+    Sweep = 1,
+    Mark = 2,
+};
+
+struct GameLogEvent
+{
+    // Milliseconds since the game started.
+    uint32_t time;
+    GameLogEventKind kind;
+    int32_t x;
+    int32_t y;
+};
+
+// Everything needed to play a game again: the board parameters, the seed and
+// every input in order. The outcome, duration and state hash are what the
+// client that recorded the game claims happened, VerifyGameLog checks them.
+struct GameLog
+{
+    uint64_t seed = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t numMines = 0;
+    std::vector<GameLogEvent> events;
+
+    GameOutcome outcome = GameOutcome::Playing;
+    uint32_t duration = 0;
+    uint64_t stateHash = 0;
+};
+
+// Logs come from clients, so boards past these limits, or with a mine count
+// that doesn't fit the board, are rejected as corrupt instead of allocated.
+// Files bigger than GameLogMaximumFileSize aren't even read.
+const int GameLogMaximumSide = 4096;
+const int64_t GameLogMaximumTiles = 4096 * 1024;
+const uint64_t GameLogMaximumFileSize = 64 * 1024 * 1024;
+
+// No one sweeps or marks faster than this for a whole second, even the
+// fastest players peak around half of it. Event times are taken when the
+// input is handled, so a frame that stalls can give a few presses the same
+// time, but it can't fit more of them into a second than were made.
+const int GameLogMaximumPressesPerSecond = 20;
+
+// The serialized form is a fixed header followed by the events, each one a
+// varint time delta and varint coordinates with the kind packed next to x.
+// A typical expert game takes a couple of bytes per event.
+void WriteGameLog(GameLog const& log, std::vector<uint8_t>& output);
+// Throws if the buffer isn't a complete game log.
+void ReadGameLog(uint8_t const* data, size_t size, GameLog& log);
+
+// Records a game as it's played.
+class GameRecorder
+{
+public:
+    GameRecorder() {}
+    ~GameRecorder() {}
+
+    // Starts a new log for the game that was just set up.
+    void Start(BoardHeader const& header);
+    // Drops the log, e.g. when a game is resumed from a save part way through.
+    void Stop() { m_recording = false; }
+    bool IsRecording() const { return m_recording; }
+
+    void Record(GameLogEventKind kind, int x, int y);
+    // Fills in the claims at the end of the log from the game's current state.
+    GameLog const& Finish(MinesweeperGame const& game);
+
+private:
+    bool m_recording = false;
+    GameLog m_log;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Plays the log through the game rules with no UI, as fast as possible. The
+// game is passed in so that its board can be reused from replay to replay.
+void ReplayGameLog(GameLog const& log, MinesweeperGame& game);
+
+// Replays the log and returns an empty string if it reproduces everything the
+// log claims, otherwise a description of the first thing that didn't match.
+// The timing is only checked to be plausible: event times never go back, no
+// second holds more than GameLogMaximumPressesPerSecond presses and the
+// duration is the time of the last event. A log that claims to be slower
+// than it really was can't be told apart.
+std::string VerifyGameLog(GameLog const& log, MinesweeperGame& game);
+
+struct GameLogFailure
+{
+    std::filesystem::path path;
+    std::string reason;
+};
+
+struct GameLogBatchResult
+{
+    size_t checked = 0;
+    // Failures whose file couldn't be read as a game log at all.
+    size_t corrupt = 0;
+    std::vector<GameLogFailure> failures;
+};
+
+// Verifies every file in directory, threadCount logs at a time (0 uses one
+// thread per core). Each thread replays with parallel sweeps off, the
+// threads already fill the cores. Failures are sorted by path.
+GameLogBatchResult VerifyGameLogDirectory(std::filesystem::path const& directory, int threadCount = 0);
@@ -0,0 +1,74 @@
+#include "pch.h"
+#include "GameProfile.h"
+
+void LatencyHistogram::Record(std::chrono::steady_clock::duration duration)
+{
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    Record(static_cast<uint64_t>(std::max<int64_t>(nanoseconds, 0)));
+}
+
+void LatencyHistogram::Record(uint64_t nanoseconds)
+{
+    m_buckets[BucketIndex(nanoseconds)]++;
+    m_count++;
+}
+
+void LatencyHistogram::Merge(LatencyHistogram const& other)
+{
+    for (auto i = 0; i < BucketCount; i++)
+    {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    auto target = static_cast<uint64_t>(std::ceil(m_count * std::min(std::max(percentile, 0.0), 100.0) / 100.0));
+    target = std::max<uint64_t>(target, 1);
+    uint64_t seen = 0;
+    for (auto i = 0; i < BucketCount; i++)
+    {
+        seen += m_buckets[i];
+        if (seen >= target)
+        {
+            return BucketUpperBound(i);
+        }
+    }
+    return BucketUpperBound(BucketCount - 1);
+}
+
+int LatencyHistogram::BucketIndex(uint64_t nanoseconds)
+{
+    if (nanoseconds < SubBuckets)
+    {
+        return static_cast<int>(nanoseconds);
+    }
+
+    // The top SubBucketBits bits below the highest set bit pick the step.
+    auto highestBit = 63;
+    while ((nanoseconds >> highestBit) == 0)
+    {
+        highestBit--;
+    }
+    auto shift = highestBit - SubBucketBits;
+    auto step = static_cast<int>((nanoseconds >> shift) & (SubBuckets - 1));
+    return (shift + 1) * SubBuckets + step;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int index)
+{
+    if (index < SubBuckets)
+    {
+        return static_cast<uint64_t>(index);
+    }
+
+    auto shift = index / SubBuckets - 1;
+    auto step = static_cast<uint64_t>(index % SubBuckets);
+    return ((SubBuckets + step) << shift) + ((1ull << shift) - 1);
+}
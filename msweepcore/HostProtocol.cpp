@@ -0,0 +1,63 @@
+#include "pch.h"
+#include "HostProtocol.h"
+
+bool ReadHostFrame(uint8_t const* data, size_t size, HostFrame& frame)
+{
+    if (size < HostFrameHeaderSize)
+    {
+        return false;
+    }
+
+    auto frameSize = ReadHostValue<uint32_t>(data);
+    if (frameSize < sizeof(HostMessageKind) || frameSize > HostMaximumFrameSize)
+    {
+        throw std::runtime_error("The host frame has an invalid size!");
+    }
+    if (size < sizeof(uint32_t) + frameSize)
+    {
+        return false;
+    }
+
+    frame.kind = static_cast<HostMessageKind>(data[sizeof(uint32_t)]);
+    frame.payload = data + HostFrameHeaderSize;
+    frame.payloadSize = frameSize - sizeof(HostMessageKind);
+    frame.frameSize = sizeof(uint32_t) + frameSize;
+    return true;
+}
+
+size_t BeginHostFrame(std::vector<uint8_t>& output, HostMessageKind kind)
+{
+    auto frameStart = output.size();
+    AppendHostValue<uint32_t>(output, 0);
+    AppendHostValue(output, kind);
+    return frameStart;
+}
+
+void EndHostFrame(std::vector<uint8_t>& output, size_t frameStart)
+{
+    auto frameSize = static_cast<uint32_t>(output.size() - frameStart - sizeof(uint32_t));
+    std::memcpy(output.data() + frameStart, &frameSize, sizeof(frameSize));
+}
+
+void WriteNewGameRequest(std::vector<uint8_t>& output, int width, int height, int mines, uint64_t seed)
+{
+    auto frameStart = BeginHostFrame(output, HostMessageKind::NewGame);
+    AppendHostValue(output, static_cast<int16_t>(width));
+    AppendHostValue(output, static_cast<int16_t>(height));
+    AppendHostValue(output, static_cast<int32_t>(mines));
+    AppendHostValue(output, seed);
+    EndHostFrame(output, frameStart);
+}
+
+void WritePressRequest(std::vector<uint8_t>& output, bool flag, int x, int y)
+{
+    auto frameStart = BeginHostFrame(output, flag ? HostMessageKind::Flag : HostMessageKind::Sweep);
+    AppendHostValue(output, static_cast<uint16_t>(x));
+    AppendHostValue(output, static_cast<uint16_t>(y));
+    EndHostFrame(output, frameStart);
+}
+
+void WriteSnapshotRequest(std::vector<uint8_t>& output)
+{
+    EndHostFrame(output, BeginHostFrame(output, HostMessageKind::Snapshot));
+}
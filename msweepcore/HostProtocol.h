@@ -0,0 +1,76 @@
+#pragma once
+
+// What GameHost and its clients send each other. Every message in either
+// direction is a frame: a little endian uint32 with the size of everything
+// after it, a HostMessageKind byte and then the payload for that kind. A
+// response has the kind of the request it answers, and requests on one
+// connection are answered in order, so clients can send several at once.
+enum class HostMessageKind : uint8_t
+{
+    // Request: int16 width, int16 height, int32 mines, uint64 seed.
+    // Response: no payload.
+    NewGame = 1,
+    // Request: uint16 x, uint16 y.
+    // Response: the PressResult byte, int32 unrevealed tiles, uint32 tile
+    // count and then every tile the press changed as a uint32 index and a
+    // look byte, see EncodeTileLook.
+    Sweep = 2,
+    Flag = 3,
+    // Request: no payload.
+    // Response: the board as a snapshot, see BoardSnapshot.h.
+    Snapshot = 4,
+    // Response only, to a request that was malformed or came before a game
+    // was started. The connection stays open.
+    Error = 255,
+};
+
+const size_t HostFrameHeaderSize = sizeof(uint32_t) + sizeof(HostMessageKind);
+// Big enough for the snapshot of the largest board a host plays.
+const uint32_t HostMaximumFrameSize = 64 * 1024 * 1024;
+
+// State in the low two bits, and for a revealed tile its count plus one
+// above them, so a mine is 0 and an eight is 9.
+inline uint8_t EncodeTileLook(MineState state, int8_t count)
+{
+    return static_cast<uint8_t>(state) | (state == MineState::Revealed ? static_cast<uint8_t>((count + 1) << 2) : 0);
+}
+inline MineState DecodeTileLookState(uint8_t look) { return static_cast<MineState>(look & 3); }
+inline int8_t DecodeTileLookCount(uint8_t look) { return static_cast<int8_t>((look >> 2) - 1); }
+
+struct HostFrame
+{
+    HostMessageKind kind;
+    uint8_t const* payload;
+    size_t payloadSize;
+    // Header included, where the next frame starts.
+    size_t frameSize;
+};
+
+// Returns false until data holds a whole frame. Throws if the frame claims
+// to be bigger than HostMaximumFrameSize, the stream can't be trusted then.
+bool ReadHostFrame(uint8_t const* data, size_t size, HostFrame& frame);
+
+// Appends a frame header to output and returns where the frame starts, so
+// that EndHostFrame can fill in its size once the payload is appended.
+size_t BeginHostFrame(std::vector<uint8_t>& output, HostMessageKind kind);
+void EndHostFrame(std::vector<uint8_t>& output, size_t frameStart);
+
+template <typename T>
+void AppendHostValue(std::vector<uint8_t>& output, T value)
+{
+    auto offset = output.size();
+    output.resize(offset + sizeof(T));
+    std::memcpy(output.data() + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T ReadHostValue(uint8_t const* data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void WriteNewGameRequest(std::vector<uint8_t>& output, int width, int height, int mines, uint64_t seed);
+void WritePressRequest(std::vector<uint8_t>& output, bool flag, int x, int y);
+void WriteSnapshotRequest(std::vector<uint8_t>& output);
@@ -0,0 +1,253 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+
+namespace
+{
+    // Shifts a column word so that each bit holds the tile above it (y - 1),
+    // pulling the top bit of the previous word across the word boundary.
+    inline uint64_t ShiftFromAbove(uint64_t current, uint64_t previous)
+    {
+        return (current << 1) | (previous >> 63);
+    }
+
+    // Shifts a column word so that each bit holds the tile below it (y + 1),
+    // pulling the bottom bit of the next word across the word boundary.
+    inline uint64_t ShiftFromBelow(uint64_t current, uint64_t next)
+    {
+        return (current >> 1) | (next << 63);
+    }
+
+    // Adds a one bit value to a four bit counter stored as bit planes.
+    inline void AddToCounter(uint64_t(&planes)[4], uint64_t value)
+    {
+        auto carry = planes[0] & value;
+        planes[0] ^= value;
+        auto nextCarry = planes[1] & carry;
+        planes[1] ^= carry;
+        carry = nextCarry;
+        nextCarry = planes[2] & carry;
+        planes[2] ^= carry;
+        planes[3] |= nextCarry;
+    }
+
+#if MSWEEP_AVX2_AVAILABLE
+    MSWEEP_AVX2_TARGET inline __m256i ShiftFromAbove(__m256i current, __m256i previous)
+    {
+        return _mm256_or_si256(_mm256_slli_epi64(current, 1), _mm256_srli_epi64(previous, 63));
+    }
+
+    MSWEEP_AVX2_TARGET inline __m256i ShiftFromBelow(__m256i current, __m256i next)
+    {
+        return _mm256_or_si256(_mm256_srli_epi64(current, 1), _mm256_slli_epi64(next, 63));
+    }
+
+    MSWEEP_AVX2_TARGET inline void AddToCounter(__m256i(&planes)[4], __m256i value)
+    {
+        auto carry = _mm256_and_si256(planes[0], value);
+        planes[0] = _mm256_xor_si256(planes[0], value);
+        auto nextCarry = _mm256_and_si256(planes[1], carry);
+        planes[1] = _mm256_xor_si256(planes[1], carry);
+        carry = nextCarry;
+        nextCarry = _mm256_and_si256(planes[2], carry);
+        planes[2] = _mm256_xor_si256(planes[2], carry);
+        planes[3] = _mm256_or_si256(planes[3], nextCarry);
+    }
+
+    MSWEEP_AVX2_TARGET inline __m256i Load(uint64_t const* words)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words));
+    }
+#endif
+}
+
+#if MSWEEP_AVX2_AVAILABLE
+bool IsAvx2Supported()
+{
+    static const bool supported = []()
+    {
+#ifdef _MSC_VER
+        int info[4] = {};
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+
+        // AVX2 needs both the instructions and the OS saving the ymm registers.
+        __cpuid(info, 1);
+        auto osxsave = (info[2] & (1 << 27)) != 0;
+        auto avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        // Checks the OS side (xgetbv) as well.
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }();
+    return supported;
+}
+#endif
+
+MineBitBoard::MineBitBoard(int width, int height)
+{
+    Reset(width, height);
+}
+
+void MineBitBoard::Reset(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    m_wordsPerColumn = (height + 63) / 64;
+    // One padding column on either side of the board.
+    m_stride = width + 2;
+
+    m_words.clear();
+    m_words.resize(static_cast<size_t>(m_stride) * (m_wordsPerColumn + 2), 0);
+}
+
+void MineBitBoard::Set(int x, int y)
+{
+    m_words[WordOffset(x, y / 64)] |= 1ull << (y % 64);
+}
+
+void MineBitBoard::SetFromBitmap(uint8_t const* bits)
+{
+    // Every column starts at an arbitrary bit of the bitmap, so each word is
+    // read as up to 9 bytes and shifted into place. Nothing past the last
+    // byte of the bitmap is read.
+    auto byteCount = (static_cast<size_t>(m_width) * m_height + 7) / 8;
+    for (auto x = 0; x < m_width; x++)
+    {
+        auto columnBit = static_cast<size_t>(x) * m_height;
+        for (auto word = 0; word < m_wordsPerColumn; word++)
+        {
+            auto bit = columnBit + static_cast<size_t>(word) * 64;
+            auto firstByte = bit / 8;
+            auto shift = bit % 8;
+            uint64_t low = 0;
+            memcpy(&low, bits + firstByte, std::min<size_t>(8, byteCount - firstByte));
+            auto value = low >> shift;
+            if (shift != 0 && firstByte + 8 < byteCount)
+            {
+                value |= static_cast<uint64_t>(bits[firstByte + 8]) << (64 - shift);
+            }
+
+            auto tiles = std::min(64, m_height - word * 64);
+            if (tiles < 64)
+            {
+                value &= (1ull << tiles) - 1;
+            }
+            m_words[WordOffset(x, word)] |= value;
+        }
+    }
+}
+
+bool MineBitBoard::Test(int x, int y) const
+{
+    return (m_words[WordOffset(x, y / 64)] >> (y % 64)) & 1;
+}
+
+void MineBitBoard::ComputeNeighborCounts(int8_t* neighborCounts, bool allowAvx2) const
+{
+    for (auto word = 0; word < m_wordsPerColumn; word++)
+    {
+        auto x = 0;
+#if MSWEEP_AVX2_AVAILABLE
+        if (allowAvx2 && IsAvx2Supported())
+        {
+            for (; x + 4 <= m_width; x += 4)
+            {
+                ComputeColumnCountsAvx2(x, word, neighborCounts);
+            }
+        }
+#endif
+        for (; x < m_width; x++)
+        {
+            ComputeColumnCountsScalar(x, word, neighborCounts);
+        }
+    }
+}
+
+void MineBitBoard::ComputeColumnCountsScalar(int x, int word, int8_t* neighborCounts) const
+{
+    auto center = WordOffset(x, word);
+    auto above = center - m_stride;
+    auto below = center + m_stride;
+
+    uint64_t planes[4] = {};
+    for (auto column = -1; column <= 1; column++)
+    {
+        auto current = m_words[center + column];
+        if (column != 0)
+        {
+            AddToCounter(planes, current);
+        }
+        AddToCounter(planes, ShiftFromAbove(current, m_words[above + column]));
+        AddToCounter(planes, ShiftFromBelow(current, m_words[below + column]));
+    }
+
+    ExtractCounts(x, word, m_words[center], planes, neighborCounts);
+}
+
+#if MSWEEP_AVX2_AVAILABLE
+MSWEEP_AVX2_TARGET void MineBitBoard::ComputeColumnCountsAvx2(int x, int word, int8_t* neighborCounts) const
+{
+    auto center = WordOffset(x, word);
+    auto above = center - m_stride;
+    auto below = center + m_stride;
+
+    __m256i planes[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+    for (auto column = -1; column <= 1; column++)
+    {
+        auto current = Load(&m_words[center + column]);
+        if (column != 0)
+        {
+            AddToCounter(planes, current);
+        }
+        AddToCounter(planes, ShiftFromAbove(current, Load(&m_words[above + column])));
+        AddToCounter(planes, ShiftFromBelow(current, Load(&m_words[below + column])));
+    }
+
+    alignas(32) uint64_t lanes[4][4];
+    for (auto plane = 0; plane < 4; plane++)
+    {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[plane]), planes[plane]);
+    }
+
+    for (auto lane = 0; lane < 4; lane++)
+    {
+        uint64_t lanePlanes[4] = { lanes[0][lane], lanes[1][lane], lanes[2][lane], lanes[3][lane] };
+        ExtractCounts(x + lane, word, m_words[center + lane], lanePlanes, neighborCounts);
+    }
+}
+#endif
+
+void MineBitBoard::ExtractCounts(int x, int word, uint64_t mines, uint64_t const (&planes)[4], int8_t* neighborCounts) const
+{
+    auto firstY = word * 64;
+    auto bits = std::min(64, m_height - firstY);
+    auto output = neighborCounts + static_cast<size_t>(x) * m_height + firstY;
+
+    for (auto bit = 0; bit < bits; bit++)
+    {
+        if ((mines >> bit) & 1)
+        {
+            // -1 means a mine
+            output[bit] = -1;
+        }
+        else
+        {
+            output[bit] = static_cast<int8_t>(
+                ((planes[0] >> bit) & 1) |
+                (((planes[1] >> bit) & 1) << 1) |
+                (((planes[2] >> bit) & 1) << 2) |
+                (((planes[3] >> bit) & 1) << 3));
+        }
+    }
+}
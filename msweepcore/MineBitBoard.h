@@ -0,0 +1,50 @@
+#pragma once
+
+#if MSWEEP_AVX2_AVAILABLE
+// Whether this CPU and OS can run the AVX2 paths. Checked once.
+bool IsAvx2Supported();
+#endif
+
+// Stores the mine layout with one bit per tile. Each column of the board (a
+// fixed x) is split into 64-bit words along y, matching the column-major order
+// used by IndexHelper. Words are laid out word-row major (every column's first
+// word, then every column's second word, ...) and surrounded by a ring of zero
+// words, so the neighbors of any word can be loaded without bounds checks.
+class MineBitBoard
+{
+public:
+    MineBitBoard() {}
+    MineBitBoard(int width, int height);
+    ~MineBitBoard() {}
+
+    void Reset(int width, int height);
+    void Set(int x, int y);
+    bool Test(int x, int y) const;
+    // Sets every tile whose bit is set in bits, one bit per tile in
+    // IndexHelper order with the first tile in the lowest bit, as snapshots
+    // store them. Goes a word of 64 tiles at a time.
+    void SetFromBitmap(uint8_t const* bits);
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+
+    // Fills neighborCounts (Width() * Height() entries, indexed like IndexHelper)
+    // with the number of mines surrounding each tile, or -1 if the tile is a mine.
+    // allowAvx2 false keeps to the scalar path even where AVX2 is supported,
+    // so the two can be checked against each other.
+    void ComputeNeighborCounts(int8_t* neighborCounts, bool allowAvx2 = true) const;
+
+private:
+    int WordOffset(int x, int word) const { return (word + 1) * m_stride + (x + 1); }
+    void ComputeColumnCountsScalar(int x, int word, int8_t* neighborCounts) const;
+#if MSWEEP_AVX2_AVAILABLE
+    void ComputeColumnCountsAvx2(int x, int word, int8_t* neighborCounts) const;
+#endif
+    void ExtractCounts(int x, int word, uint64_t mines, uint64_t const (&planes)[4], int8_t* neighborCounts) const;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_wordsPerColumn = 0;
+    int m_stride = 0;
+    std::vector<uint64_t> m_words;
+};
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "MineRings.h"
+
+void MineRings::Compute(int width, int height, int8_t const* neighborCounts, int centerX, int centerY)
+{
+    m_ringMines.clear();
+    m_mineIndices.clear();
+    m_minesPerRing.clear();
+
+    // The board is scanned column by column, which already visits each side
+    // of a ring in walk order: the top and bottom sides left to right, the
+    // left and right sides (single columns) top to bottom. So a stable
+    // counting sort by ring and side is all the ordering that's needed.
+    auto ringCount = std::max({ centerX, width - 1 - centerX, centerY, height - 1 - centerY }) + 1;
+    m_sideOffsets.assign(static_cast<size_t>(ringCount) * 4 + 1, 0);
+    for (auto x = 0; x < width; x++)
+    {
+        auto column = neighborCounts + static_cast<size_t>(x) * height;
+        auto dx = x - centerX;
+        for (auto y = 0; y < height; y++)
+        {
+            // -1 means a mine
+            if (column[y] >= 0)
+            {
+                continue;
+            }
+
+            auto dy = y - centerY;
+            auto ring = std::max(std::abs(dx), std::abs(dy));
+            if (ring == 0)
+            {
+                continue;
+            }
+
+            // A corner belongs to the side the walk reaches it on first.
+            int side;
+            if (dy == -ring)
+            {
+                side = 0;
+            }
+            else if (dx == ring)
+            {
+                side = 1;
+            }
+            else if (dy == ring)
+            {
+                side = 2;
+            }
+            else
+            {
+                side = 3;
+            }
+            auto key = ring * 4 + side;
+            m_ringMines.push_back({ key, x * height + y });
+            m_sideOffsets[key + 1]++;
+        }
+    }
+
+    m_minesPerRing.push_back(1);
+    for (auto ring = 1; ring < ringCount; ring++)
+    {
+        auto minesInRing = 0;
+        for (auto side = 0; side < 4; side++)
+        {
+            minesInRing += m_sideOffsets[ring * 4 + side + 1];
+        }
+        if (minesInRing > 0)
+        {
+            m_minesPerRing.push_back(minesInRing);
+        }
+    }
+
+    // Offsets start at 1 to leave room for the center.
+    m_sideOffsets[0] = 1;
+    for (size_t i = 1; i < m_sideOffsets.size(); i++)
+    {
+        m_sideOffsets[i] += m_sideOffsets[i - 1];
+    }
+    m_mineIndices.resize(m_ringMines.size() + 1);
+    m_mineIndices[0] = centerX * height + centerY;
+    for (auto& mine : m_ringMines)
+    {
+        m_mineIndices[m_sideOffsets[mine.ringSide]++] = mine.index;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Orders the mines of a board ring by ring around a center tile, which is how
+// the game over animation plays them. Ring r is every tile r steps away in
+// Chebyshev distance. Within a ring the mines come in the order of a walk
+// along the top side left to right, the right side top to bottom, the bottom
+// side left to right and then the left side top to bottom. Only the mines are
+// looked at after one pass over the counts, so the cost doesn't depend on how
+// far the rings reach past the board's edges.
+class MineRings
+{
+public:
+    MineRings() {}
+    ~MineRings() {}
+
+    // neighborCounts is width * height entries indexed like IndexHelper,
+    // with -1 for a mine. The center always comes first in a ring of its
+    // own, it's the mine that was hit.
+    void Compute(int width, int height, int8_t const* neighborCounts, int centerX, int centerY);
+
+    // Every mine, ring by ring, as tile indices.
+    std::vector<int> const& MineIndices() const { return m_mineIndices; }
+    // How many of MineIndices are in each ring, skipping rings without mines.
+    std::vector<int> const& MinesPerRing() const { return m_minesPerRing; }
+
+private:
+    struct RingMine
+    {
+        // ring * 4 + side, with the sides numbered in walk order.
+        int ringSide;
+        int index;
+    };
+
+private:
+    std::vector<RingMine> m_ringMines;
+    std::vector<int> m_sideOffsets;
+    std::vector<int> m_mineIndices;
+    std::vector<int> m_minesPerRing;
+};
@@ -0,0 +1,339 @@
+#include "pch.h"
+#include "MineSolver.h"
+
+namespace
+{
+    // Neighbor k is opposite neighbor 7 - k.
+    const int NeighborX[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+    const int NeighborY[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+
+    // Constraints are compared with every other constraint up to this many
+    // tiles away, so the board is padded by this many tiles on every side.
+    const int Padding = 2;
+
+    inline int CountBits(uint64_t value)
+    {
+        return static_cast<int>(std::bitset<64>(value).count());
+    }
+
+    inline int LowestBit(uint64_t value)
+    {
+        return CountBits((value & (~value + 1)) - 1);
+    }
+
+    // Two constraints whose neighborhoods overlap are at most two tiles apart,
+    // so both fit in a 7x7 window centered on the first one. The table maps a
+    // constraint's offset from the center and its 8 bit neighbor mask to the
+    // same tiles as window bits.
+    struct WindowTable
+    {
+        uint64_t bits[5][5][256];
+
+        WindowTable()
+        {
+            for (auto offsetY = -2; offsetY <= 2; offsetY++)
+            {
+                for (auto offsetX = -2; offsetX <= 2; offsetX++)
+                {
+                    for (auto mask = 0; mask < 256; mask++)
+                    {
+                        uint64_t window = 0;
+                        for (auto k = 0; k < 8; k++)
+                        {
+                            if ((mask >> k) & 1)
+                            {
+                                auto windowX = offsetX + NeighborX[k] + 3;
+                                auto windowY = offsetY + NeighborY[k] + 3;
+                                window |= 1ull << (windowY * 7 + windowX);
+                            }
+                        }
+                        bits[offsetY + 2][offsetX + 2][mask] = window;
+                    }
+                }
+            }
+        }
+    };
+
+    WindowTable const& Windows()
+    {
+        static const WindowTable table;
+        return table;
+    }
+}
+
+void MineSolver::Solve(
+    int width,
+    int height,
+    MineState const* mineStates,
+    int8_t const* neighborCounts,
+    bool trustFlags,
+    std::vector<int>& safeTiles,
+    std::vector<int>& mineTiles)
+{
+    m_width = width;
+    m_height = height;
+    m_layout = PaddedLayout(width, height, Padding);
+    for (auto k = 0; k < 8; k++)
+    {
+        m_neighborOffsets[k] = m_layout.NeighborOffset(NeighborX[k], NeighborY[k]);
+    }
+    for (auto bit = 0; bit < 49; bit++)
+    {
+        m_windowOffsets[bit] = m_layout.NeighborOffset(bit % 7 - 3, bit / 7 - 3);
+    }
+
+    // The padding is made of revealed tiles that aren't constraints, which
+    // the searches below treat like any other settled tile.
+    auto paddedCount = m_layout.TileCount();
+    m_tiles.assign(paddedCount, SolverTile::Safe);
+    m_isConstraint.assign(paddedCount, 0);
+    // Only ever read for constraints, which set them before anything else.
+    m_unknownMasks.resize(paddedCount);
+    m_remainingMines.resize(paddedCount);
+
+    // A solve runs until both queues are empty, which leaves every queued
+    // flag clear again, so the flags are only cleared when the size changes.
+    // Anything still queued was left behind by a solve that threw.
+    if (m_queued.size() != paddedCount)
+    {
+        m_queued.assign(paddedCount, 0);
+        m_pairQueued.assign(paddedCount, 0);
+    }
+    else
+    {
+        for (auto index : m_queue)
+        {
+            m_queued[index] = 0;
+        }
+        for (auto index : m_pairQueue)
+        {
+            m_pairQueued[index] = 0;
+        }
+    }
+    m_queue.clear();
+    m_pairQueue.clear();
+
+    // Board order is column major, index = x * height + y.
+    for (auto x = 0; x < width; x++)
+    {
+        auto column = mineStates + static_cast<size_t>(x) * height;
+        auto counts = neighborCounts + static_cast<size_t>(x) * height;
+        auto paddedColumn = m_tiles.data() + PaddedIndex(x, 0);
+        for (auto y = 0; y < height; y++)
+        {
+            if (column[y] == MineState::Revealed)
+            {
+                // A revealed mine only happens once the game is lost.
+                paddedColumn[y] = counts[y] < 0 ? SolverTile::Mine : SolverTile::Safe;
+            }
+            else
+            {
+                paddedColumn[y] = trustFlags && column[y] == MineState::Flag ? SolverTile::Mine : SolverTile::Unknown;
+            }
+        }
+    }
+
+    for (auto x = 0; x < width; x++)
+    {
+        auto column = mineStates + static_cast<size_t>(x) * height;
+        auto counts = neighborCounts + static_cast<size_t>(x) * height;
+        for (auto y = 0; y < height; y++)
+        {
+            if (column[y] != MineState::Revealed || counts[y] <= 0)
+            {
+                continue;
+            }
+
+            auto index = PaddedIndex(x, y);
+            uint8_t mask = 0;
+            int remaining = counts[y];
+            for (auto k = 0; k < 8; k++)
+            {
+                auto neighbor = m_tiles[index + m_neighborOffsets[k]];
+                if (neighbor == SolverTile::Unknown)
+                {
+                    mask |= 1 << k;
+                }
+                else if (neighbor == SolverTile::Mine)
+                {
+                    remaining--;
+                }
+            }
+
+            // Numbered tiles are never padding, so a count of 0 for padding is harmless.
+            m_isConstraint[index] = 1;
+            m_unknownMasks[index] = mask;
+            m_remainingMines[index] = static_cast<int8_t>(remaining);
+            if (mask != 0)
+            {
+                Enqueue(index);
+            }
+        }
+    }
+
+    while (!m_queue.empty() || !m_pairQueue.empty())
+    {
+        if (m_queue.empty())
+        {
+            auto index = m_pairQueue.back();
+            m_pairQueue.pop_back();
+            m_pairQueued[index] = 0;
+
+            if (m_unknownMasks[index] != 0 && ComparePairs(index, safeTiles, mineTiles))
+            {
+                // There may be more to learn from this constraint against its other neighbors.
+                Enqueue(index);
+            }
+            continue;
+        }
+
+        auto index = m_queue.back();
+        m_queue.pop_back();
+        m_queued[index] = 0;
+
+        auto mask = m_unknownMasks[index];
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        auto remaining = m_remainingMines[index];
+        auto unknowns = CountBits(mask);
+        if (remaining < 0 || remaining > unknowns)
+        {
+            // Only possible with a wrong flag that we were told to trust.
+            continue;
+        }
+
+        if (remaining == 0)
+        {
+            SettleMask(index, mask, SolverTile::Safe, safeTiles, mineTiles);
+        }
+        else if (remaining == unknowns)
+        {
+            SettleMask(index, mask, SolverTile::Mine, safeTiles, mineTiles);
+        }
+        else if (!m_pairQueued[index])
+        {
+            // Comparing against neighbors is much more expensive, so it waits
+            // until the single checks have nothing left to settle.
+            m_pairQueued[index] = 1;
+            m_pairQueue.push_back(index);
+        }
+    }
+}
+
+SolverTile MineSolver::Tile(int index) const
+{
+    return m_tiles[PaddedIndex(index / m_height, index % m_height)];
+}
+
+bool MineSolver::ComparePairs(int index, std::vector<int>& safeTiles, std::vector<int>& mineTiles)
+{
+    auto& windows = Windows();
+    auto window = windows.bits[2][2][m_unknownMasks[index]];
+    int remaining = m_remainingMines[index];
+
+    for (auto offsetX = -2; offsetX <= 2; offsetX++)
+    {
+        for (auto offsetY = -2; offsetY <= 2; offsetY++)
+        {
+            auto other = index + m_layout.NeighborOffset(offsetX, offsetY);
+            auto otherMask = m_unknownMasks[other];
+            if (other == index || !m_isConstraint[other] || otherMask == 0)
+            {
+                continue;
+            }
+
+            auto otherWindow = windows.bits[offsetY + 2][offsetX + 2][otherMask];
+            if ((window & otherWindow) == 0)
+            {
+                continue;
+            }
+
+            int otherRemaining = m_remainingMines[other];
+            if (otherRemaining < 0 || otherRemaining > CountBits(otherWindow))
+            {
+                continue;
+            }
+
+            // The shared tiles hold the same mines for both constraints, so
+            // the difference in mines has to come from the tiles only one of
+            // them touches. If one side needs every one of its own tiles to
+            // make up the difference, the other side's own tiles are all safe.
+            auto onlyHere = window & ~otherWindow;
+            auto onlyThere = otherWindow & ~window;
+            if (remaining - otherRemaining == CountBits(onlyHere))
+            {
+                if (onlyHere == 0 && onlyThere == 0)
+                {
+                    continue;
+                }
+                SettleWindow(index, onlyHere, SolverTile::Mine, safeTiles, mineTiles);
+                SettleWindow(index, onlyThere, SolverTile::Safe, safeTiles, mineTiles);
+                return true;
+            }
+            if (otherRemaining - remaining == CountBits(onlyThere))
+            {
+                SettleWindow(index, onlyThere, SolverTile::Mine, safeTiles, mineTiles);
+                SettleWindow(index, onlyHere, SolverTile::Safe, safeTiles, mineTiles);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void MineSolver::Settle(int index, SolverTile tile, std::vector<int>& safeTiles, std::vector<int>& mineTiles)
+{
+    if (m_tiles[index] != SolverTile::Unknown)
+    {
+        return;
+    }
+
+    m_tiles[index] = tile;
+    auto x = m_layout.ComputeXFromIndex(index);
+    auto y = m_layout.ComputeYFromIndex(index);
+    (tile == SolverTile::Mine ? mineTiles : safeTiles).push_back(x * m_height + y);
+
+    // The tile is no longer an unknown of any constraint around it.
+    for (auto k = 0; k < 8; k++)
+    {
+        auto neighbor = index + m_neighborOffsets[k];
+        if (m_isConstraint[neighbor])
+        {
+            m_unknownMasks[neighbor] &= static_cast<uint8_t>(~(1 << (7 - k)));
+            if (tile == SolverTile::Mine)
+            {
+                m_remainingMines[neighbor]--;
+            }
+            Enqueue(neighbor);
+        }
+    }
+}
+
+void MineSolver::SettleMask(int index, uint8_t mask, SolverTile tile, std::vector<int>& safeTiles, std::vector<int>& mineTiles)
+{
+    for (; mask != 0; mask &= mask - 1)
+    {
+        Settle(index + m_neighborOffsets[LowestBit(mask)], tile, safeTiles, mineTiles);
+    }
+}
+
+void MineSolver::SettleWindow(int index, uint64_t window, SolverTile tile, std::vector<int>& safeTiles, std::vector<int>& mineTiles)
+{
+    for (; window != 0; window &= window - 1)
+    {
+        Settle(index + m_windowOffsets[LowestBit(window)], tile, safeTiles, mineTiles);
+    }
+}
+
+void MineSolver::Enqueue(int index)
+{
+    if (!m_queued[index])
+    {
+        m_queued[index] = 1;
+        m_queue.push_back(index);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+enum class SolverTile : uint8_t
+{
+    Unknown = 0,
+    Safe = 1,
+    Mine = 2,
+};
+
+// Finds every unrevealed tile that can be proven safe or a mine from what the
+// player can see: the revealed tiles and their neighbor counts. Counts of
+// unrevealed tiles are never read. Each numbered tile is a constraint on an
+// 8 bit mask of its unknown neighbors. Single constraints are settled when
+// they need none or all of their unknowns, and pairs of nearby constraints
+// are compared as 7x7 bit windows so that subset, superset and overlapping
+// ("1-2-1") deductions are a handful of bit operations. The buffers are kept
+// between solves, so solving many boards with one solver doesn't allocate.
+class MineSolver
+{
+public:
+    MineSolver() {}
+    ~MineSolver() {}
+
+    // Appends the index of every provable tile to safeTiles or mineTiles. If
+    // trustFlags is true the player's flags are taken as mines, otherwise
+    // flagged tiles are unknowns like any other (and may be reported as
+    // safe). Question marks are always unknowns.
+    void Solve(
+        int width,
+        int height,
+        MineState const* mineStates,
+        int8_t const* neighborCounts,
+        bool trustFlags,
+        std::vector<int>& safeTiles,
+        std::vector<int>& mineTiles);
+
+    // What the last Solve settled each tile as. Revealed tiles are Safe.
+    SolverTile Tile(int index) const;
+
+    // The same through the padded copy the solver works on, for callers that
+    // walk neighbors. The border is two tiles of Safe, so a neighbor off the
+    // board reads as Safe instead of needing a bounds check.
+    PaddedLayout const& Layout() const { return m_layout; }
+    SolverTile PaddedTile(int paddedIndex) const { return m_tiles[paddedIndex]; }
+
+private:
+    // Everything below works on padded indices.
+    int PaddedIndex(int x, int y) const { return m_layout.ComputeIndex(x, y); }
+    void Settle(int index, SolverTile tile, std::vector<int>& safeTiles, std::vector<int>& mineTiles);
+    void SettleMask(int index, uint8_t mask, SolverTile tile, std::vector<int>& safeTiles, std::vector<int>& mineTiles);
+    void SettleWindow(int index, uint64_t window, SolverTile tile, std::vector<int>& safeTiles, std::vector<int>& mineTiles);
+    bool ComparePairs(int index, std::vector<int>& safeTiles, std::vector<int>& mineTiles);
+    void Enqueue(int index);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    PaddedLayout m_layout;
+    int m_neighborOffsets[8] = {};
+    int m_windowOffsets[49] = {};
+    std::vector<SolverTile> m_tiles;
+    // For each revealed tile, its unknown neighbors and how many of them are mines.
+    std::vector<uint8_t> m_unknownMasks;
+    std::vector<int8_t> m_remainingMines;
+    std::vector<uint8_t> m_isConstraint;
+    // Constraints waiting for the cheap single checks, and those that passed
+    // them without settling anything and wait to be compared against their
+    // neighbors. Pairs are only compared once the single checks run dry.
+    std::vector<uint8_t> m_queued;
+    std::vector<int> m_queue;
+    std::vector<uint8_t> m_pairQueued;
+    std::vector<int> m_pairQueue;
+};
@@ -0,0 +1,90 @@
+#include "pch.h"
+#include "MineRings.h"
+#include "MineTimeline.h"
+
+// The scale at the start, the peak and the end of a mine's animation, and
+// how far through it the peak comes. Between them the scale is linear.
+static const float RestingScale = 1.0f;
+static const float PeakScale = 2.0f;
+static const float PeakProgress = 0.7f;
+
+static float ComputeMineScale(float progress)
+{
+    if (progress >= 1.0f)
+    {
+        return RestingScale;
+    }
+    if (progress < PeakProgress)
+    {
+        return RestingScale + (PeakScale - RestingScale) * (progress / PeakProgress);
+    }
+    return PeakScale + (RestingScale - PeakScale) * ((progress - PeakProgress) / (1.0f - PeakProgress));
+}
+
+// How long after the animation starts a ring starts.
+static std::chrono::steady_clock::duration RingStart(size_t ring)
+{
+    return MineTimeline::RingDelay * static_cast<int64_t>(ring);
+}
+
+void MineTimeline::Start(MineRings const& rings)
+{
+    m_mineIndices.assign(rings.MineIndices().begin(), rings.MineIndices().end());
+    m_ringEnds.clear();
+    auto ringEnd = 0;
+    for (auto minesInRing : rings.MinesPerRing())
+    {
+        ringEnd += minesInRing;
+        m_ringEnds.push_back(ringEnd);
+    }
+
+    m_firstPlayingRing = 0;
+    m_nextRing = 0;
+    m_frame.clear();
+    m_start = m_clock.Now();
+    m_end = m_ringEnds.empty() ? m_start : m_start + RingStart(m_ringEnds.size() - 1) + MineDuration;
+}
+
+void MineTimeline::Stop()
+{
+    m_firstPlayingRing = m_ringEnds.size();
+    m_nextRing = m_ringEnds.size();
+    m_frame.clear();
+    m_end = m_start;
+}
+
+bool MineTimeline::IsPlaying() const
+{
+    return m_clock.Now() < m_end;
+}
+
+bool MineTimeline::Tick()
+{
+    m_frame.clear();
+    if (m_firstPlayingRing == m_ringEnds.size())
+    {
+        return false;
+    }
+
+    auto elapsed = m_clock.Now() - m_start;
+    auto startedRing = m_nextRing;
+    while (m_nextRing < m_ringEnds.size() && RingStart(m_nextRing) <= elapsed)
+    {
+        m_nextRing++;
+    }
+
+    for (auto ring = m_firstPlayingRing; ring < m_nextRing; ring++)
+    {
+        auto ringElapsed = elapsed - RingStart(ring);
+        auto progress = std::chrono::duration<float>(ringElapsed) / std::chrono::duration<float>(MineDuration);
+        auto firstMine = ring == 0 ? 0 : m_ringEnds[ring - 1];
+        m_frame.push_back({ firstMine, m_ringEnds[ring] - firstMine, ComputeMineScale(progress), ring >= startedRing });
+
+        // Rings finish in the order they started.
+        if (progress >= 1.0f && ring == m_firstPlayingRing)
+        {
+            m_firstPlayingRing++;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+class MineRings;
+
+// Where animations get the time from. The UI uses SteadyAnimationClock,
+// benchmarks and anything else without a display can step a
+// ManualAnimationClock instead and get the same frames every run.
+class AnimationClock
+{
+public:
+    virtual ~AnimationClock() {}
+    virtual std::chrono::steady_clock::time_point Now() const = 0;
+};
+
+class SteadyAnimationClock : public AnimationClock
+{
+public:
+    std::chrono::steady_clock::time_point Now() const override { return std::chrono::steady_clock::now(); }
+};
+
+class ManualAnimationClock : public AnimationClock
+{
+public:
+    std::chrono::steady_clock::time_point Now() const override { return m_now; }
+    void Advance(std::chrono::steady_clock::duration duration) { m_now += duration; }
+
+private:
+    std::chrono::steady_clock::time_point m_now;
+};
+
+// One ring's part of a frame: the mines at [firstMine, firstMine + mineCount)
+// in MineTimeline::MineIndices all have this scale.
+struct MineRingFrame
+{
+    int firstMine;
+    int mineCount;
+    float scale;
+    // The ring started since the last frame, its mines should be brought to
+    // the top so they grow over their neighbors.
+    bool started;
+};
+
+// The game over animation, worked out on the CPU. Every mine scales from 1
+// up to 2 and back over MineDuration, a ring at a time, with each ring
+// starting RingDelay after the one before it. The schedule is only the mine
+// indices and where each ring ends, and at most MineDuration / RingDelay + 1
+// rings are ever playing at once, so a tick only looks at the rings that are
+// playing and a frame only lists those.
+class MineTimeline
+{
+public:
+    static constexpr std::chrono::milliseconds RingDelay{ 100 };
+    static constexpr std::chrono::milliseconds MineDuration{ 600 };
+
+    // The clock has to outlive the timeline.
+    MineTimeline(AnimationClock const& clock) : m_clock(clock) {}
+    ~MineTimeline() {}
+
+    // Starts the animation at the clock's current time.
+    void Start(MineRings const& rings);
+    void Stop();
+
+    // Whether input should wait, going by the clock alone, so it doesn't
+    // matter how often the animation is ticked.
+    bool IsPlaying() const;
+
+    // Works out the frame for the clock's current time. A ring that has
+    // finished is in one last frame at a scale of 1 and then left out.
+    // Returns false once there is nothing left to draw.
+    bool Tick();
+
+    std::vector<int> const& MineIndices() const { return m_mineIndices; }
+    std::vector<MineRingFrame> const& Frame() const { return m_frame; }
+
+private:
+    AnimationClock const& m_clock;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_end;
+
+    std::vector<int> m_mineIndices;
+    // Where each ring's mines end in m_mineIndices.
+    std::vector<int> m_ringEnds;
+    // The rings before m_firstPlayingRing are done, the ones from
+    // m_nextRing on haven't started.
+    size_t m_firstPlayingRing = 0;
+    size_t m_nextRing = 0;
+    std::vector<MineRingFrame> m_frame;
+};
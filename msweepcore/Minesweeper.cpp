@@ -1,7 +1,22 @@
 #include "pch.h"
+#include "TileUpdates.h"
 #include "CompUI.h"
 #include "VisualGrid.h"
 #include "CompAssets.h"
+#include "MineBitBoard.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "MinesweeperGame.h"
+#include "MineRings.h"
+#include "MineTimeline.h"
+#include "GameLog.h"
+#include "PointerInputQueue.h"
 #include "Minesweeper.h"
 
 using namespace winrt;
@@ -19,27 +34,15 @@ std::shared_ptr<IMinesweeper> CreateMinesweeper(
     return std::make_shared<Minesweeper>(parentVisual, parentSize);
 }
 
-MineState CycleMineState(MineState const& mineState)
-{
-    switch (mineState)
-    {
-    case MineState::Empty:
-        return MineState::Flag;
-    case MineState::Flag:
-        return MineState::Question;
-    case MineState::Question:
-        return MineState::Empty;
-    case MineState::Revealed:
-        throw std::runtime_error("We shouldn't be cycling a revealed tile!");
-    }
-}
-
 Minesweeper::Minesweeper(
     ContainerVisual const& parentVisual,
     float2 parentSize)
 {
     auto boardSizeInTiles = SizeInt32{ 16, 16 };
     m_ui = std::make_unique<CompUI>(parentVisual, parentSize, boardSizeInTiles);
+    // Every press hands its tile changes to the UI in one batch.
+    m_game.SetTileUpdateSink(m_ui.get());
+    m_game.SetKeepHistory(true);
 
     NewGame(boardSizeInTiles.Width, boardSizeInTiles.Height, 40);
     OnParentSizeChanged(parentSize);
@@ -47,7 +50,36 @@ Minesweeper::Minesweeper(
 
 void Minesweeper::OnPointerMoved(float2 point)
 {
-    if (m_gameOver || m_ui->IsAnimationPlaying())
+    m_input.Move(point.x, point.y);
+}
+
+void Minesweeper::OnPointerPressed(
+    bool isRightButton,
+    bool isEraser)
+{
+    m_input.Press(isRightButton, isEraser);
+}
+
+void Minesweeper::ProcessInput()
+{
+    m_input.Take(m_pendingInput);
+    for (auto& input : m_pendingInput)
+    {
+        switch (input.kind)
+        {
+        case PointerInputKind::Move:
+            HandlePointerMoved({ input.x, input.y });
+            break;
+        case PointerInputKind::Press:
+            HandlePointerPressed(input.isRightButton, input.isEraser);
+            break;
+        }
+    }
+}
+
+void Minesweeper::HandlePointerMoved(float2 point)
+{
+    if (m_game.IsGameOver() || m_mineTimeline.IsPlaying())
     {
         return;
     }
@@ -55,11 +87,20 @@ void Minesweeper::OnPointerMoved(float2 point)
     std::optional<TileCoordinate> selectedTile = std::nullopt;
     if (auto tile = m_ui->HitTest(point))
     {
-        if (m_mineStates[m_indexHelper->ComputeIndex(tile->x, tile->y)] != MineState::Revealed)
+        if (m_game.MineStates()[m_game.Indices().ComputeIndex(tile->x, tile->y)] != MineState::Revealed)
         {
             selectedTile.swap(std::optional<TileCoordinate>(tile));
         }
     }
+
+    if (selectedTile)
+    {
+        auto currentSelection = m_ui->CurrentSelectedTile();
+        if (!currentSelection || currentSelection->x != selectedTile->x || currentSelection->y != selectedTile->y)
+        {
+            m_recorder.Record(GameLogEventKind::Select, selectedTile->x, selectedTile->y);
+        }
+    }
     m_ui->SelectTile(selectedTile);
 }
 
@@ -68,340 +109,199 @@ void Minesweeper::OnParentSizeChanged(float2 newSize)
     m_ui->Resize(newSize);
 }
 
-void Minesweeper::OnPointerPressed(
+void Minesweeper::HandlePointerPressed(
     bool isRightButton,
     bool isEraser)
 {
-    if (m_gameOver && !m_ui->IsAnimationPlaying())
+    if (m_game.IsGameOver() && !m_mineTimeline.IsPlaying())
     {
-        NewGame(m_gameBoardWidth, m_gameBoardWidth, m_numMines);
+        NewGame(m_game.Width(), m_game.Height(), m_game.Header().numMines);
     }
 
     if (auto currentSelection = m_ui->CurrentSelectedTile())
     {
-        int index = m_indexHelper->ComputeIndex(currentSelection->x, currentSelection->y);
+        auto mark = isRightButton || isEraser;
+        if (!m_game.IsGameOver())
+        {
+            m_recorder.Record(mark ? GameLogEventKind::Mark : GameLogEventKind::Sweep, currentSelection->x, currentSelection->y);
+        }
 
-        if (m_mineStates[index] != MineState::Revealed)
+        // The press hands the tiles it changed to the UI itself.
+        switch (m_game.Press(currentSelection->x, currentSelection->y, mark))
         {
-            if (isRightButton || isEraser)
-            {
-                auto state = CycleMineState(m_mineStates[index]);
-                m_mineStates[index] = state;
-                m_ui->UpdateTileWithState(*currentSelection, state);
-            }
-            else if (m_mineStates[index] == MineState::Empty)
-            {
-                if (Sweep(currentSelection->x, currentSelection->y))
-                {
-                    // We hit a mine! Setup and play an animation while locking any input.
-                    auto hitX = currentSelection->x;
-                    auto hitY = currentSelection->y;
-
-                    // First, hide the selection visual and reset the selection
-                    m_ui->SelectTile(std::nullopt);
-
-                    PlayAnimationOnAllMines(hitX, hitY);
-
-                    m_gameOver = true;
-                }
-                else if (CheckIfWon())
-                {
-                    m_ui->SelectTile(std::nullopt);
-                    // TODO: Play a win animation
-                    m_gameOver = true;
-                }
-            }
+        case PressResult::HitMine:
+            // We hit a mine! Setup and play an animation while locking any input.
+            // First, hide the selection visual and reset the selection
+            m_ui->SelectTile(std::nullopt);
+
+            PlayAnimationOnAllMines(currentSelection->x, currentSelection->y);
+            break;
+        case PressResult::Won:
+            m_ui->SelectTile(std::nullopt);
+            // TODO: Play a win animation
+            break;
         }
+        ShowMines();
     }
+    m_game.Autosave();
 }
 
-void Minesweeper::NewGame(int boardWidth, int boardHeight, int mines)
+void Minesweeper::NewGame(int boardWidth, int boardHeight, int mines, std::optional<uint64_t> seed)
 {
-    m_gameBoardWidth = boardWidth;
-    m_gameBoardHeight = boardHeight;
-    m_indexHelper = std::make_unique<IndexHelper>(boardWidth, boardHeight);
-
-    m_ui->Reset({ boardWidth, boardHeight });
-    m_mineStates.clear();
+    m_game.NewGame(boardWidth, boardHeight, mines, seed);
+    ResetUI();
+    m_recorder.Start(m_game.Header());
+}
 
-    for (auto i = 0; i < boardWidth * boardHeight; i++)
-    {
-        m_mineStates.push_back(MineState::Empty);
-    }
+bool Minesweeper::Undo()
+{
+    return StepHistory(true);
+}
 
-    m_gameOver = false;
-    m_mineGenerationState = MineGenerationState::Deferred;
-    m_numMines = mines;
+bool Minesweeper::Redo()
+{
+    return StepHistory(false);
 }
 
-bool Minesweeper::Sweep(int x, int y)
+bool Minesweeper::StepHistory(bool undo)
 {
-    if (m_mineGenerationState == MineGenerationState::Deferred)
+    // Presses that were queued first happen first.
+    ProcessInput();
+    if (m_mineTimeline.IsPlaying())
     {
-        // We don't want the first thing that the user clicks to be a mine. 
-        // Generate mines but avoid putting it where the user clicked.
-        GenerateMines(m_numMines, x, y);
-        m_mineGenerationState = MineGenerationState::Generated;
+        return false;
     }
 
-    bool hitMine = false;
-    std::queue<int> sweeps;
-    sweeps.push(m_indexHelper->ComputeIndex(x, y));
-    Reveal(sweeps.front());
-
-    while (!sweeps.empty())
+    // The game hands the tiles that differ to the UI itself.
+    auto wasLost = m_game.Header().outcome == GameOutcome::Lost;
+    if (!(undo ? m_game.Undo() : m_game.Redo()))
     {
-        int index = sweeps.front();
-        int currentx = m_indexHelper->ComputeXFromIndex(index);
-        int currenty = m_indexHelper->ComputeYFromIndex(index);
-
-        if (m_mines[index])
-        {
-            // We hit a mine, game over
-            hitMine = true;
-            break;
-        }
-
-        if (m_neighborCounts[index] == 0)
-        {
-            PushIfUnmarked(sweeps, currentx - 1, currenty - 1);
-            PushIfUnmarked(sweeps, currentx, currenty - 1);
-            PushIfUnmarked(sweeps, currentx + 1, currenty - 1);
-            PushIfUnmarked(sweeps, currentx + 1, currenty);
-            PushIfUnmarked(sweeps, currentx + 1, currenty + 1);
-            PushIfUnmarked(sweeps, currentx, currenty + 1);
-            PushIfUnmarked(sweeps, currentx - 1, currenty + 1);
-            PushIfUnmarked(sweeps, currentx - 1, currenty);
-        }
-
-        sweeps.pop();
+        return false;
     }
-
-    return hitMine;
-}
-
-void Minesweeper::Reveal(int index)
-{
-    auto tileCoordinate = TileCoordinate{ m_indexHelper->ComputeXFromIndex(index), m_indexHelper->ComputeYFromIndex(index) };
-
-    if (m_mines[index])
+    if (wasLost)
     {
-        m_ui->UpdateTileAsMine(tileCoordinate);
+        // Losing drew every mine, which only the UI knows about.
+        ResetUI();
+        ShowBoard();
     }
-    else
+    if (m_game.IsGameOver())
     {
-        int count = m_neighborCounts[index];
-        m_ui->UpdateTileWithMineCount(tileCoordinate, count);
+        m_ui->SelectTile(std::nullopt);
     }
 
-    m_mineStates[index] = MineState::Revealed;
+    // The log only holds presses, it can't say one was taken back.
+    m_recorder.Stop();
+    m_game.Autosave();
+    return true;
 }
 
-bool Minesweeper::IsInBoundsAndUnmarked(int x, int y)
+void Minesweeper::OpenBoardFile(std::wstring const& path)
 {
-    int index = m_indexHelper->ComputeIndex(x, y);
-    return m_indexHelper->IsInBounds(x, y) && m_mineStates[index] == MineState::Empty;
-}
-
-void Minesweeper::PushIfUnmarked(std::queue<int> & sweeps, int x, int y)
-{
-    if (IsInBoundsAndUnmarked(x, y))
+    bool opened = false;
+    try
     {
-        int index = m_indexHelper->ComputeIndex(x, y);
-        Reveal(index);
-        sweeps.push(index);
+        opened = m_game.OpenBoardFile(path);
     }
-}
-
-void Minesweeper::GenerateMines(int numMines, int excludeX, int excludeY)
-{
-    m_mines.clear();
-    for (int x = 0; x < m_gameBoardWidth; x++)
+    catch (...)
     {
-        for (int y = 0; y < m_gameBoardHeight; y++)
-        {
-            m_mines.push_back(false);
-        }
+        // The game fell back to a new board in memory.
+        ResetUI();
+        m_recorder.Start(m_game.Header());
+        throw;
     }
 
-    srand(time(0));
-    for (int i = 0; i < numMines; i++)
-    {
-        int index = -1;
-        auto excludeIndex = m_indexHelper->ComputeIndex(excludeX, excludeY);
-        do
-        {
-            index = GenerateIndex(0, m_gameBoardWidth * m_gameBoardHeight - 1);
-        } while (index == excludeIndex || m_mines[index]);
+    ResetUI();
+    ShowBoard();
 
-        m_mines[index] = true;
+    // A board that was picked back up can't be logged from the start.
+    if (opened)
+    {
+        m_recorder.Stop();
     }
-
-    m_neighborCounts.clear();
-    for (int i = 0; i < m_mines.size(); i++)
+    else
     {
-        int x = m_indexHelper->ComputeXFromIndex(i);
-        int y = m_indexHelper->ComputeYFromIndex(i);
-
-        if (m_mines[i])
-        {
-            // -1 means a mine
-            m_neighborCounts.push_back(-1);
-            // DEBUG
-#if SHOW_MINES
-            m_ui->UpdateTileWithState({ x, y }, MineState::Question);
-#endif
-        }
-        else
-        {
-            int count = GetSurroundingMineCount(x, y);
-            m_neighborCounts.push_back(count);
-        }
+        m_recorder.Start(m_game.Header());
     }
 }
 
-int Minesweeper::GenerateIndex(int min, int max)
+void Minesweeper::CloseBoardFile()
 {
-    return min + (rand() % static_cast<int>(max - min + 1));
+    m_game.CloseBoardFile();
+    ResetUI();
+    m_recorder.Start(m_game.Header());
 }
 
-bool Minesweeper::TestSpot(int x, int y)
+void Minesweeper::SaveSnapshot(std::vector<uint8_t>& snapshot)
 {
-    return m_indexHelper->IsInBounds(x, y) && m_mines[m_indexHelper->ComputeIndex(x, y)];
+    m_game.SaveSnapshot(snapshot);
 }
 
-int Minesweeper::GetSurroundingMineCount(int x, int y)
+void Minesweeper::LoadSnapshot(uint8_t const* data, size_t size)
 {
-    int count = 0;
-
-    if (TestSpot(x + 1, y))
-    {
-        count++;
-    }
-
-    if (TestSpot(x - 1, y))
-    {
-        count++;
-    }
-
-    if (TestSpot(x, y + 1))
-    {
-        count++;
-    }
-
-    if (TestSpot(x, y - 1))
-    {
-        count++;
-    }
-
-    if (TestSpot(x + 1, y + 1))
-    {
-        count++;
-    }
+    m_game.LoadSnapshot(data, size);
+    ResetUI();
+    ShowBoard();
+    m_recorder.Stop();
+}
 
-    if (TestSpot(x - 1, y - 1))
-    {
-        count++;
-    }
+void Minesweeper::SetAutosavePath(std::wstring const& path)
+{
+    m_game.SetAutosavePath(path);
+}
 
-    if (TestSpot(x - 1, y + 1))
-    {
-        count++;
-    }
+void Minesweeper::SaveGameLog(std::vector<uint8_t>& log)
+{
+    WriteGameLog(m_recorder.Finish(m_game), log);
+}
 
-    if (TestSpot(x + 1, y - 1))
+bool Minesweeper::Animate()
+{
+    if (!m_mineTimeline.Tick())
     {
-        count++;
+        return false;
     }
+    m_ui->ApplyMineFrame(m_mineTimeline.MineIndices(), m_mineTimeline.Frame());
+    return true;
+}
 
-    return count;
+void Minesweeper::ResetUI()
+{
+    // An animation that was still playing has no tiles left to draw on.
+    m_mineTimeline.Stop();
+    m_ui->Reset({ m_game.Width(), m_game.Height() });
 }
 
-void Minesweeper::CheckTileForMineForAnimation(int x, int y, std::queue<int>& mineIndices, int& visitedTiles, int& minesInRing)
+void Minesweeper::ShowBoard()
 {
-    if (m_indexHelper->IsInBounds(x, y))
-    {
-        auto tileIndex = m_indexHelper->ComputeIndex(x, y);
-        if (m_mines[tileIndex])
-        {
-            mineIndices.push(tileIndex);
-            minesInRing++;
-        }
-        visitedTiles++;
-    }
+    // Bring the UI up to date with a board that was played before.
+    m_game.SendBoardTileUpdates();
 }
 
-void Minesweeper::PlayAnimationOnAllMines(int centerX, int centerY)
+void Minesweeper::ShowMines()
 {
-    // Build a queue that contains the indices of the mines in a spiral starting from the clicked mine.
-    std::queue<int> mineIndices;
-    std::queue<int> minesPerRing;
-    int visitedTiles = 0;
-    int ringLevel = 0;
-    while (visitedTiles < (m_gameBoardWidth * m_gameBoardHeight))
+    // DEBUG
+#if SHOW_MINES
+    if (m_game.Header().mineGenerationState == MineGenerationState::Generated && !m_game.IsGameOver())
     {
-        if (ringLevel == 0)
-        {
-            auto hitMineIndex = m_indexHelper->ComputeIndex(centerX, centerY);
-            mineIndices.push(hitMineIndex);
-            minesPerRing.push(1);
-            visitedTiles++;
-        }
-        else
+        auto& indices = m_game.Indices();
+        for (int i = 0; i < m_game.Width() * m_game.Height(); i++)
         {
-            auto currentMinesInRing = 0;
-
-            // Check the top side
-            for (auto x = centerX - ringLevel; x <= (centerX + ringLevel); x++)
-            {
-                auto y = centerY - ringLevel;
-                CheckTileForMineForAnimation(x, y, mineIndices, visitedTiles, currentMinesInRing);
-            }
-
-            // Check the right side
-            for (auto y = centerY - ringLevel + 1; y <= (centerY + ringLevel); y++)
-            {
-                auto x = centerX + ringLevel;
-                CheckTileForMineForAnimation(x, y, mineIndices, visitedTiles, currentMinesInRing);
-            }
-
-            // Check the bottom side
-            for (auto x = centerX - ringLevel; x < (centerX + ringLevel); x++)
-            {
-                auto y = centerY + ringLevel;
-                CheckTileForMineForAnimation(x, y, mineIndices, visitedTiles, currentMinesInRing);
-            }
-
-            // Check the left side
-            for (auto y = centerY - ringLevel + 1; y < (centerY + ringLevel); y++)
+            if (m_game.IsMine(i) && m_game.MineStates()[i] == MineState::Empty)
             {
-                auto x = centerX - ringLevel;
-                CheckTileForMineForAnimation(x, y, mineIndices, visitedTiles, currentMinesInRing);
-            }
-
-            if (currentMinesInRing > 0)
-            {
-                minesPerRing.push(currentMinesInRing);
+                m_ui->UpdateTileWithState({ indices.ComputeXFromIndex(i), indices.ComputeYFromIndex(i) }, MineState::Question);
             }
         }
-        ringLevel++;
     }
-
-    // Iterate and animate each mine
-    m_ui->PlayMineAnimations(mineIndices, minesPerRing);
+#endif
 }
 
-bool Minesweeper::CheckIfWon()
+void Minesweeper::PlayAnimationOnAllMines(int centerX, int centerY)
 {
-    // Get the number of non-revealed tiles
-    auto nonRevealedTiles = 0;
-    for (auto& state : m_mineStates)
-    {
-        if (state != MineState::Revealed)
-        {
-            nonRevealedTiles += 1;
-        }
-    }
-
-    return nonRevealedTiles == m_numMines;
-}
+    MineRings rings;
+    m_game.ComputeMineRings(centerX, centerY, rings);
+
+    // Every mine shows at once, then they grow a ring at a time as the
+    // host calls Animate.
+    m_mineTimeline.Start(rings);
+    m_ui->UpdateTilesAsMines(m_mineTimeline.MineIndices());
+}
\ No newline at end of file
@@ -14,38 +14,56 @@ public:
     void OnPointerPressed(
         bool isRightButton,
         bool isEraser) override;
+    void ProcessInput() override;
+    bool Animate() override;
+
+    void NewGame(int boardWidth, int boardHeight, int mines, std::optional<uint64_t> seed = std::nullopt) override;
+    uint64_t Seed() override { return m_game.Header().seed; }
+    void SetNoGuess(bool noGuess) override { m_game.SetNoGuess(noGuess); }
+
+    bool Undo() override;
+    bool Redo() override;
+
+    void OpenBoardFile(std::wstring const& path) override;
+    void CloseBoardFile() override;
+
+    void SaveSnapshot(std::vector<uint8_t>& snapshot) override;
+    void LoadSnapshot(uint8_t const* data, size_t size) override;
+    void SetAutosavePath(std::wstring const& path) override;
+
+    void SaveGameLog(std::vector<uint8_t>& log) override;
+
+    int UnrevealedTiles() override { return m_game.Header().unrevealedTiles; }
+    int FlagsPlaced() override { return m_game.Header().flagsPlaced; }
+    int SafeTilesRemaining() override { return m_game.Header().unrevealedTiles - m_game.Header().numMines; }
+    int MinesRemaining() override { return m_game.Header().numMines - m_game.Header().flagsPlaced; }
 
 private:
-    void NewGame(int boardWidth, int boardHeight, int mines);
-    bool Sweep(int x, int y);
-    void Reveal(int index);
-    bool IsInBoundsAndUnmarked(int x, int y);
-    void PushIfUnmarked(std::queue<int>& sweeps, int x, int y);
-    void GenerateMines(int numMines, int excludeX, int excludeY);
-    int GenerateIndex(int min, int max);
-    bool TestSpot(int x, int y);
-    int GetSurroundingMineCount(int x, int y);
-    void CheckTileForMineForAnimation(int x, int y, std::queue<int>& mineIndices, int& visitedTiles, int& minesInRing);
+    void HandlePointerMoved(winrt::Windows::Foundation::Numerics::float2 point);
+    void HandlePointerPressed(
+        bool isRightButton,
+        bool isEraser);
+    bool StepHistory(bool undo);
+    void ResetUI();
+    void ShowBoard();
+    void ShowMines();
     void PlayAnimationOnAllMines(int centerX, int centerY);
     winrt::Windows::UI::Composition::CompositionShape GetShapeFromMineCount(int count);
     winrt::Windows::UI::Composition::CompositionSpriteShape GetDotShape(
         winrt::Windows::UI::Composition::CompositionGeometry const& geometry,
         winrt::Windows::UI::Composition::CompositionColorBrush const& brush,
         winrt::Windows::Foundation::Numerics::float2 offset);
-    bool CheckIfWon();
 
 private:
     std::unique_ptr<CompUI> m_ui;
 
-    int m_gameBoardWidth;
-    int m_gameBoardHeight;
-    std::unique_ptr<IndexHelper> m_indexHelper;
+    // All of the rules live in the game, this class only mirrors it into the UI.
+    MinesweeperGame m_game;
+    GameRecorder m_recorder;
 
-    std::vector<MineState> m_mineStates;
-    std::vector<bool> m_mines;
-    std::vector<int> m_neighborCounts;
-    MineGenerationState m_mineGenerationState = MineGenerationState::Deferred;
-    int m_numMines = 0;
+    PointerInputQueue m_input;
+    std::vector<PointerInput> m_pendingInput;
 
-    bool m_gameOver = false;
+    SteadyAnimationClock m_clock;
+    MineTimeline m_mineTimeline{ m_clock };
 };
\ No newline at end of file
@@ -0,0 +1,726 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "TilePacking.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "PresetBoard.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "GameProfile.h"
+#include "MineRings.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+
+// Boards with fewer tiles than this are always swept on the input thread.
+static const int ParallelSweepMinimumTiles = 1 << 20;
+
+void GenerateMineLayout(uint64_t seed, int numMines, int excludeIndex, MineBitBoard& mines)
+{
+    // Floyd's sampling, so each mine costs one random number no matter how
+    // dense the board is.
+    auto height = mines.Height();
+    SampleMineLayout(seed, numMines, excludeIndex, mines.Width() * height,
+        [&mines, height](int index) { return mines.Test(index / height, index % height); },
+        [&mines, height](int index) { mines.Set(index / height, index % height); });
+}
+
+MineState CycleMineState(MineState const& mineState)
+{
+    switch (mineState)
+    {
+    case MineState::Empty:
+        return MineState::Flag;
+    case MineState::Flag:
+        return MineState::Question;
+    case MineState::Question:
+        return MineState::Empty;
+    case MineState::Revealed:
+    default:
+        throw std::runtime_error("We shouldn't be cycling a revealed tile!");
+    }
+}
+
+void MinesweeperGame::NewGame(int boardWidth, int boardHeight, int mines, std::optional<uint64_t> seed)
+{
+    CreateBoard(boardWidth, boardHeight);
+
+    m_header->numMines = std::min(mines, boardWidth * boardHeight - 1);
+    if (seed)
+    {
+        m_header->seed = *seed;
+    }
+    else
+    {
+        std::random_device device;
+        m_header->seed = (static_cast<uint64_t>(device()) << 32) | device();
+    }
+    ResetHistory();
+}
+
+void MinesweeperGame::SetNoGuess(bool noGuess)
+{
+    m_noGuess = noGuess;
+    if (m_noGuess && !m_noGuessGenerator)
+    {
+        m_noGuessGenerator = std::make_unique<NoGuessGenerator>();
+    }
+}
+
+PressResult MinesweeperGame::Press(int x, int y, bool mark)
+{
+    m_revealedSpans.clear();
+    if (IsGameOver() || !m_indexHelper->IsInBounds(x, y))
+    {
+        return PressResult::None;
+    }
+
+    auto index = m_indexHelper->ComputeIndex(x, y);
+    if (m_mineStates[index] == MineState::Revealed)
+    {
+        return PressResult::None;
+    }
+
+    if (mark)
+    {
+        CycleTile(index);
+        KeepPressVersion(index, false);
+        if (m_tileUpdateSink)
+        {
+            auto update = MakeTileUpdate(index);
+            m_tileUpdateSink->ApplyTileUpdates(&update, 1);
+        }
+        return PressResult::Marked;
+    }
+
+    if (m_mineStates[index] != MineState::Empty)
+    {
+        return PressResult::None;
+    }
+
+    auto minesGenerated = m_header->mineGenerationState == MineGenerationState::Deferred;
+    if (minesGenerated)
+    {
+        auto start = m_profile ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        GenerateFirstMines(x, y);
+        if (m_profile)
+        {
+            m_profile->generateMines.Record(std::chrono::steady_clock::now() - start);
+        }
+    }
+
+    auto start = m_profile ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    auto hitMine = Sweep(x, y);
+    if (m_profile)
+    {
+        m_profile->sweep.Record(std::chrono::steady_clock::now() - start);
+    }
+    SendRevealedTileUpdates();
+
+    auto result = PressResult::Revealed;
+    if (hitMine)
+    {
+        m_header->outcome = GameOutcome::Lost;
+        result = PressResult::HitMine;
+    }
+    else if (CheckIfWon())
+    {
+        m_header->outcome = GameOutcome::Won;
+        result = PressResult::Won;
+    }
+
+    KeepPressVersion(-1, minesGenerated);
+    return result;
+}
+
+void MinesweeperGame::SetKeepHistory(bool keepHistory)
+{
+    m_keepHistory = keepHistory;
+    ResetHistory();
+}
+
+bool MinesweeperGame::Undo()
+{
+    if (!CanUndo())
+    {
+        return false;
+    }
+
+    ApplyVersion(m_history[m_historyPosition - 1], &m_history[m_historyPosition]);
+    m_historyPosition--;
+    return true;
+}
+
+bool MinesweeperGame::Redo()
+{
+    if (!CanRedo())
+    {
+        return false;
+    }
+
+    ApplyVersion(m_history[m_historyPosition + 1], &m_history[m_historyPosition]);
+    m_historyPosition++;
+    return true;
+}
+
+BoardVersion MinesweeperGame::CurrentVersion() const
+{
+    return IsKeepingHistory() ? m_history[m_historyPosition] : CaptureVersion();
+}
+
+BoardVersion MinesweeperGame::CaptureVersion() const
+{
+    auto tileCount = static_cast<size_t>(m_gameBoardWidth) * m_gameBoardHeight;
+    BoardVersion version;
+    version.header = *m_header;
+    version.mineStates.Assign(reinterpret_cast<uint8_t const*>(m_mineStates), tileCount);
+    version.neighborCounts.Assign(reinterpret_cast<uint8_t const*>(m_neighborCounts), tileCount);
+    return version;
+}
+
+void MinesweeperGame::RestoreVersion(BoardVersion const& version)
+{
+    auto sameSize = version.header.width == m_gameBoardWidth && version.header.height == m_gameBoardHeight;
+    ApplyVersion(version, IsKeepingHistory() && sameSize ? &m_history[m_historyPosition] : nullptr);
+    if (!IsKeepingHistory() && IsAutosaving())
+    {
+        m_autosaveVersion = version;
+    }
+    if (IsKeepingHistory())
+    {
+        if (!sameSize)
+        {
+            // The old versions don't fit the new board.
+            m_history.clear();
+        }
+        KeepVersion(BoardVersion(version));
+    }
+}
+
+#ifdef _WIN32
+bool MinesweeperGame::OpenBoardFile(std::wstring const& path)
+{
+    auto numMines = m_header->numMines;
+    m_boardPath = path;
+
+    bool opened = false;
+    try
+    {
+        opened = m_board.OpenMapped(path);
+    }
+    catch (...)
+    {
+        // The old board is already closed, fall back to a game in memory.
+        m_boardPath.clear();
+        NewGame(m_gameBoardWidth, m_gameBoardHeight, numMines);
+        throw;
+    }
+
+    if (opened)
+    {
+        BindBoard();
+        ResetHistory();
+    }
+    else
+    {
+        NewGame(m_gameBoardWidth, m_gameBoardHeight, numMines);
+    }
+    return opened;
+}
+
+void MinesweeperGame::CloseBoardFile()
+{
+    auto numMines = m_header->numMines;
+    m_boardPath.clear();
+    NewGame(m_gameBoardWidth, m_gameBoardHeight, numMines);
+}
+#endif
+
+void MinesweeperGame::SaveSnapshot(std::vector<uint8_t>& snapshot) const
+{
+    WriteSnapshot(*m_header, m_mineStates, m_neighborCounts, SnapshotMineEncoding::Seed, snapshot);
+}
+
+void MinesweeperGame::LoadSnapshot(uint8_t const* data, size_t size)
+{
+    SnapshotView snapshot(data, size);
+    auto& header = snapshot.Header();
+
+    NewGame(header.width, header.height, header.numMines, header.seed);
+    if (header.mineGenerationState == MineGenerationState::Generated)
+    {
+        if (snapshot.HasMineBitmap())
+        {
+            MineBitBoard mines(m_gameBoardWidth, m_gameBoardHeight);
+            mines.SetFromBitmap(snapshot.PackedMines());
+            CountMines(mines);
+        }
+        else
+        {
+            GenerateMines(m_header->numMines, m_indexHelper->ComputeXFromIndex(header.firstClickIndex), m_indexHelper->ComputeYFromIndex(header.firstClickIndex));
+        }
+        m_header->mineGenerationState = MineGenerationState::Generated;
+    }
+
+    UnpackTileStates(snapshot.PackedTileStates(), static_cast<size_t>(m_gameBoardWidth) * m_gameBoardHeight, m_mineStates);
+    m_header->unrevealedTiles = header.unrevealedTiles;
+    m_header->flagsPlaced = header.flagsPlaced;
+    m_header->outcome = header.outcome;
+    ResetHistory();
+}
+
+void MinesweeperGame::SetAutosavePath(std::wstring const& path)
+{
+    // Destroying the old autosaver finishes writing anything it has pending.
+    m_autosaver.reset();
+    if (!path.empty())
+    {
+        m_autosaver = std::make_unique<SnapshotAutosaver>(path, SnapshotMineEncoding::Seed);
+    }
+    m_autosaveVersion = IsAutosaving() && !IsKeepingHistory() && m_header ? CaptureVersion() : BoardVersion();
+}
+
+void MinesweeperGame::Autosave()
+{
+    if (IsAutosaving())
+    {
+        // Copying a version only copies its chunk tables, serializing and
+        // the disk write both happen on the autosaver's thread.
+        m_autosaver->Submit(IsKeepingHistory() ? m_history[m_historyPosition] : m_autosaveVersion);
+    }
+}
+
+bool MinesweeperGame::IsMine(int index) const
+{
+    // -1 means a mine
+    return m_neighborCounts[index] < 0;
+}
+
+uint64_t MinesweeperGame::ComputeStateHash() const
+{
+    auto hash = 0xcbf29ce484222325ull;
+    auto add = [&hash](uint8_t const* data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= data[i];
+            hash *= 0x100000001b3ull;
+        }
+    };
+
+    int32_t values[] = { m_header->width, m_header->height, m_header->numMines, m_header->unrevealedTiles, m_header->flagsPlaced };
+    add(reinterpret_cast<uint8_t const*>(values), sizeof(values));
+    add(reinterpret_cast<uint8_t const*>(&m_header->outcome), sizeof(m_header->outcome));
+    add(reinterpret_cast<uint8_t const*>(m_mineStates), static_cast<size_t>(m_gameBoardWidth) * m_gameBoardHeight);
+    return hash;
+}
+
+void MinesweeperGame::CreateBoard(int width, int height)
+{
+#ifdef _WIN32
+    if (!m_boardPath.empty())
+    {
+        m_board.CreateMapped(m_boardPath, width, height);
+        BindBoard();
+        return;
+    }
+#endif
+    m_board.Create(width, height);
+    BindBoard();
+}
+
+void MinesweeperGame::BindBoard()
+{
+    m_header = m_board.Header();
+    m_mineStates = m_board.MineStates();
+    m_neighborCounts = m_board.NeighborCounts();
+
+    m_gameBoardWidth = m_header->width;
+    m_gameBoardHeight = m_header->height;
+    m_indexHelper = std::make_unique<IndexHelper>(m_gameBoardWidth, m_gameBoardHeight);
+    m_presetBoard = m_usePresetBoards ? FindPresetBoard(m_gameBoardWidth, m_gameBoardHeight) : nullptr;
+}
+
+void MinesweeperGame::SetUsePresetBoards(bool usePresetBoards)
+{
+    m_usePresetBoards = usePresetBoards;
+    m_presetBoard = m_usePresetBoards && m_header ? FindPresetBoard(m_gameBoardWidth, m_gameBoardHeight) : nullptr;
+}
+
+void MinesweeperGame::GenerateFirstMines(int x, int y)
+{
+    if (m_noGuess)
+    {
+        auto seed = m_noGuessGenerator->FindSeed(
+            m_gameBoardWidth,
+            m_gameBoardHeight,
+            m_header->numMines,
+            m_indexHelper->ComputeIndex(x, y),
+            m_header->seed);
+        if (seed)
+        {
+            m_header->seed = *seed;
+        }
+    }
+
+    // We don't want the first thing that the user clicks to be a mine.
+    // Generate mines but avoid putting it where the user clicked.
+    GenerateMines(m_header->numMines, x, y);
+    m_header->mineGenerationState = MineGenerationState::Generated;
+}
+
+bool MinesweeperGame::Sweep(int x, int y)
+{
+    auto index = m_indexHelper->ComputeIndex(x, y);
+    if (IsMine(index))
+    {
+        // We hit a mine, game over
+        Reveal(index);
+        return true;
+    }
+
+    if (m_neighborCounts[index] > 0)
+    {
+        Reveal(index);
+        return false;
+    }
+
+    // Open up everything connected to this tile a column run at a time. Huge
+    // boards split the work into stripes of columns across threads.
+    if (m_presetBoard)
+    {
+        m_presetBoard->floodFill(m_mineStates, m_neighborCounts, x, y, m_revealedSpans);
+    }
+    else if (m_parallelSweep && m_gameBoardWidth * m_gameBoardHeight >= ParallelSweepMinimumTiles && m_parallelFloodFill.ThreadCount() > 1)
+    {
+        m_parallelFloodFill.Fill(
+            m_mineStates,
+            m_neighborCounts,
+            m_gameBoardWidth,
+            m_gameBoardHeight,
+            x,
+            y,
+            m_revealedSpans);
+    }
+    else
+    {
+        m_floodFill.Fill(
+            m_mineStates,
+            m_neighborCounts,
+            m_gameBoardWidth,
+            m_gameBoardHeight,
+            x,
+            y,
+            m_revealedSpans);
+    }
+
+    for (auto& span : m_revealedSpans)
+    {
+        m_header->unrevealedTiles -= span.length;
+    }
+
+    return false;
+}
+
+void MinesweeperGame::Reveal(int index)
+{
+    m_mineStates[index] = MineState::Revealed;
+    m_header->unrevealedTiles--;
+    m_revealedSpans.push_back({ m_indexHelper->ComputeXFromIndex(index), m_indexHelper->ComputeYFromIndex(index), 1 });
+}
+
+void MinesweeperGame::CycleTile(int index)
+{
+    auto state = CycleMineState(m_mineStates[index]);
+    if (state == MineState::Flag)
+    {
+        m_header->flagsPlaced++;
+    }
+    else if (m_mineStates[index] == MineState::Flag)
+    {
+        m_header->flagsPlaced--;
+    }
+
+    m_mineStates[index] = state;
+}
+
+TileUpdate MinesweeperGame::MakeTileUpdate(int index) const
+{
+    auto state = m_mineStates[index];
+    return { index, state, state == MineState::Revealed ? m_neighborCounts[index] : static_cast<int8_t>(0) };
+}
+
+void MinesweeperGame::SendRevealedTileUpdates()
+{
+    if (!m_tileUpdateSink || m_revealedSpans.empty())
+    {
+        return;
+    }
+
+    size_t updateCount = 0;
+    for (auto& span : m_revealedSpans)
+    {
+        updateCount += span.length;
+    }
+    m_tileUpdates.resize(updateCount);
+
+    auto update = m_tileUpdates.data();
+    for (auto& span : m_revealedSpans)
+    {
+        auto index = m_indexHelper->ComputeIndex(span.x, span.y);
+        for (auto i = 0; i < span.length; i++)
+        {
+            *update++ = { index + i, MineState::Revealed, m_neighborCounts[index + i] };
+        }
+    }
+    m_tileUpdateSink->ApplyTileUpdates(m_tileUpdates.data(), m_tileUpdates.size());
+}
+
+void MinesweeperGame::SendBoardTileUpdates()
+{
+    if (!m_tileUpdateSink)
+    {
+        return;
+    }
+
+    m_tileUpdates.clear();
+    for (auto index = 0; index < m_gameBoardWidth * m_gameBoardHeight; index++)
+    {
+        if (m_mineStates[index] != MineState::Empty)
+        {
+            m_tileUpdates.push_back(MakeTileUpdate(index));
+        }
+    }
+    if (!m_tileUpdates.empty())
+    {
+        m_tileUpdateSink->ApplyTileUpdates(m_tileUpdates.data(), m_tileUpdates.size());
+    }
+}
+
+void MinesweeperGame::ResetHistory()
+{
+    m_history.clear();
+    m_historyPosition = 0;
+    m_autosaveVersion = BoardVersion();
+    if (IsKeepingHistory() && m_header)
+    {
+        // The first version is the only one that copies the whole board.
+        m_history.push_back(CaptureVersion());
+    }
+    else if (IsAutosaving() && m_header)
+    {
+        m_autosaveVersion = CaptureVersion();
+    }
+}
+
+void MinesweeperGame::KeepPressVersion(int markedIndex, bool minesGenerated)
+{
+    if (IsKeepingHistory())
+    {
+        // Start from the version before the press, which shares everything.
+        auto version = m_history[m_historyPosition];
+        WritePressChunks(version, markedIndex, minesGenerated);
+        KeepVersion(std::move(version));
+    }
+    else if (IsAutosaving())
+    {
+        WritePressChunks(m_autosaveVersion, markedIndex, minesGenerated);
+    }
+}
+
+void MinesweeperGame::WritePressChunks(BoardVersion& version, int markedIndex, bool minesGenerated)
+{
+    // Copy out of the board only the chunks the press wrote to.
+    version.header = *m_header;
+
+    m_dirtyChunks.clear();
+    if (markedIndex >= 0)
+    {
+        m_dirtyChunks.push_back(markedIndex / TileChunks::ChunkTiles);
+    }
+    for (auto& span : m_revealedSpans)
+    {
+        auto first = static_cast<size_t>(m_indexHelper->ComputeIndex(span.x, span.y));
+        auto last = first + span.length - 1;
+        for (auto chunk = first / TileChunks::ChunkTiles; chunk <= last / TileChunks::ChunkTiles; chunk++)
+        {
+            m_dirtyChunks.push_back(chunk);
+        }
+    }
+    // Short runs put many spans in one chunk, copy it once.
+    std::sort(m_dirtyChunks.begin(), m_dirtyChunks.end());
+    m_dirtyChunks.erase(std::unique(m_dirtyChunks.begin(), m_dirtyChunks.end()), m_dirtyChunks.end());
+    for (auto chunk : m_dirtyChunks)
+    {
+        version.mineStates.WriteChunk(reinterpret_cast<uint8_t const*>(m_mineStates), chunk);
+    }
+
+    // The counts only change once a game, when the mines are placed.
+    if (minesGenerated)
+    {
+        version.neighborCounts.Assign(reinterpret_cast<uint8_t const*>(m_neighborCounts), version.neighborCounts.Size());
+    }
+}
+
+void MinesweeperGame::KeepVersion(BoardVersion&& version)
+{
+    // A new version replaces everything that could have been redone.
+    if (!m_history.empty())
+    {
+        m_history.resize(m_historyPosition + 1);
+    }
+    m_history.push_back(std::move(version));
+    m_historyPosition = m_history.size() - 1;
+}
+
+void MinesweeperGame::ApplyVersion(BoardVersion const& version, BoardVersion const* current)
+{
+    auto& header = version.header;
+    if (header.width != m_gameBoardWidth || header.height != m_gameBoardHeight)
+    {
+        CreateBoard(header.width, header.height);
+        current = nullptr;
+    }
+
+    m_revealedSpans.clear();
+    m_tileUpdates.clear();
+    auto& states = version.mineStates;
+    auto& counts = version.neighborCounts;
+    auto sharesChunk = [&](size_t chunk)
+    {
+        return current && states.SharesChunk(current->mineStates, chunk) && counts.SharesChunk(current->neighborCounts, chunk);
+    };
+    for (size_t table = 0; table < states.TableCount(); table++)
+    {
+        if (current && states.SharesTable(current->mineStates, table) && counts.SharesTable(current->neighborCounts, table))
+        {
+            continue;
+        }
+
+        auto end = std::min(states.ChunkCount(), (table + 1) * TileChunks::ChunksPerTable);
+        for (auto chunk = table * TileChunks::ChunksPerTable; chunk < end; chunk++)
+        {
+            if (sharesChunk(chunk))
+            {
+                continue;
+            }
+
+            auto first = chunk * TileChunks::ChunkTiles;
+            auto size = states.ChunkSize(chunk);
+            auto chunkStates = reinterpret_cast<MineState const*>(states.Chunk(chunk));
+            auto chunkCounts = reinterpret_cast<int8_t const*>(counts.Chunk(chunk));
+            if (m_tileUpdateSink)
+            {
+                for (size_t i = 0; i < size; i++)
+                {
+                    auto index = static_cast<int>(first + i);
+                    auto state = chunkStates[i];
+                    auto revealed = state == MineState::Revealed;
+                    if (state != m_mineStates[index] || (revealed && chunkCounts[i] != m_neighborCounts[index]))
+                    {
+                        m_tileUpdates.push_back({ index, state, revealed ? chunkCounts[i] : static_cast<int8_t>(0) });
+                    }
+                }
+            }
+            std::memcpy(m_mineStates + first, chunkStates, size);
+            std::memcpy(m_neighborCounts + first, chunkCounts, size);
+        }
+    }
+    *m_header = header;
+
+    if (m_tileUpdateSink && !m_tileUpdates.empty())
+    {
+        m_tileUpdateSink->ApplyTileUpdates(m_tileUpdates.data(), m_tileUpdates.size());
+    }
+}
+
+void MinesweeperGame::GenerateMines(int numMines, int excludeX, int excludeY)
+{
+    auto excludeIndex = m_indexHelper->ComputeIndex(excludeX, excludeY);
+    m_header->firstClickIndex = excludeIndex;
+    if (m_presetBoard)
+    {
+        // The same layout and counts, straight into the board.
+        m_presetBoard->generateNeighborCounts(m_header->seed, numMines, excludeIndex, m_neighborCounts);
+        return;
+    }
+
+    // The bit board is only needed until the counts have been computed.
+    MineBitBoard mines(m_gameBoardWidth, m_gameBoardHeight);
+    GenerateMineLayout(m_header->seed, numMines, excludeIndex, mines);
+
+    CountMines(mines);
+}
+
+void MinesweeperGame::CountMines(MineBitBoard const& mines)
+{
+    // Count every tile's neighbors at once using the bit board, 64 tiles at a time.
+    mines.ComputeNeighborCounts(m_neighborCounts);
+}
+
+bool MinesweeperGame::TestSpot(int x, int y) const
+{
+    return m_indexHelper->IsInBounds(x, y) && IsMine(m_indexHelper->ComputeIndex(x, y));
+}
+
+int MinesweeperGame::GetSurroundingMineCount(int x, int y) const
+{
+    int count = 0;
+
+    if (TestSpot(x + 1, y))
+    {
+        count++;
+    }
+
+    if (TestSpot(x - 1, y))
+    {
+        count++;
+    }
+
+    if (TestSpot(x, y + 1))
+    {
+        count++;
+    }
+
+    if (TestSpot(x, y - 1))
+    {
+        count++;
+    }
+
+    if (TestSpot(x + 1, y + 1))
+    {
+        count++;
+    }
+
+    if (TestSpot(x - 1, y - 1))
+    {
+        count++;
+    }
+
+    if (TestSpot(x - 1, y + 1))
+    {
+        count++;
+    }
+
+    if (TestSpot(x + 1, y - 1))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+void MinesweeperGame::ComputeMineRings(int centerX, int centerY, MineRings& rings) const
+{
+    rings.Compute(m_gameBoardWidth, m_gameBoardHeight, m_neighborCounts, centerX, centerY);
+}
+
+bool MinesweeperGame::CheckIfWon() const
+{
+    // Every tile that isn't a mine has been revealed.
+    return m_header->unrevealedTiles == m_header->numMines;
+}
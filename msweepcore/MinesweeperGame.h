@@ -0,0 +1,198 @@
+#pragma once
+
+enum class PressResult
+{
+    // The press didn't change anything, e.g. sweeping a flagged tile.
+    None,
+    Marked,
+    Revealed,
+    HitMine,
+    Won,
+};
+
+struct GameProfile;
+struct PresetBoardKernels;
+class MineRings;
+
+// Places numMines mines on the (empty) bit board, never on excludeIndex. The
+// same seed and excluded tile always give the same layout, which is what lets
+// a seed and a first click stand in for the whole board.
+void GenerateMineLayout(uint64_t seed, int numMines, int excludeIndex, MineBitBoard& mines);
+
+// The rules of the game with no UI attached. Minesweeper drives this from
+// pointer input and mirrors every change into CompUI, replays drive it
+// straight from a log.
+class MinesweeperGame
+{
+public:
+    MinesweeperGame() {}
+    ~MinesweeperGame() {}
+
+    void NewGame(int boardWidth, int boardHeight, int mines, std::optional<uint64_t> seed = std::nullopt);
+
+    // When on, the first sweep searches for a seed whose layout can be
+    // solved without guessing and switches the game to it. The header's seed
+    // is then the one that was found. The search gives up after
+    // NoGuessGenerator::DefaultTimeBudgetMilliseconds, and then the layout
+    // comes from the original seed as usual.
+    void SetNoGuess(bool noGuess);
+    bool NoGuess() const { return m_noGuess; }
+
+    // Records how long mine generation and every sweep take into profile,
+    // which must outlive the game or be unset. Null (the default) turns the
+    // timing off.
+    void SetProfile(GameProfile* profile) { m_profile = profile; }
+
+    // On by default. Boards the size of a classic preset then generate and
+    // sweep through PresetBoard, which knows their size at compile time.
+    // Off sends every board down the runtime-sized path, for comparing the
+    // two. The results are the same either way.
+    void SetUsePresetBoards(bool usePresetBoards);
+
+    // On by default. Sweeps on boards of a million tiles or more then flood
+    // on a pool with one thread per hardware thread, started by the first
+    // such sweep and kept until the game is destroyed. Turn it off where many
+    // games run side by side, like host sessions and log verifiers, so they
+    // don't each start a pool. The results are the same either way.
+    void SetParallelSweep(bool parallelSweep) { m_parallelSweep = parallelSweep; }
+
+    // Hands every tile a press changes to sink as one batch once the press
+    // is done. sink must outlive the game or be unset. Null (the default)
+    // skips building the batch.
+    void SetTileUpdateSink(TileUpdateSink* sink) { m_tileUpdateSink = sink; }
+    // Sends every tile that isn't Empty as one batch, to bring the sink up
+    // to date with a board that was loaded or picked back up.
+    void SendBoardTileUpdates();
+
+    // Sweeps the tile, or cycles its mark if mark is true. The tiles revealed
+    // by a sweep are left in RevealedSpans.
+    PressResult Press(int x, int y, bool mark);
+    std::vector<TileSpan> const& RevealedSpans() const { return m_revealedSpans; }
+
+    // When on, every press that changes the board keeps a version of it for
+    // Undo and Redo to move between. Versions share the chunks of tiles they
+    // have in common, so each one costs about what its press changed, but
+    // the first one copies the whole board. A new game, a loaded board or
+    // turning history off drops every version. While a board file is open
+    // no versions are kept, whatever this is set to: the file can be bigger
+    // than memory. History picks back up once the file is closed.
+    void SetKeepHistory(bool keepHistory);
+    bool KeepHistory() const { return m_keepHistory; }
+    bool CanUndo() const { return m_historyPosition > 0; }
+    bool CanRedo() const { return m_historyPosition + 1 < m_history.size(); }
+    // Both hand the tiles that change to the sink as one batch. They return
+    // false if there is nothing to move to.
+    bool Undo();
+    bool Redo();
+
+    // The board as it is now. With history on this shares every chunk with
+    // the game, so forking a game to try a press costs next to nothing: keep
+    // the version, play on, then restore it.
+    BoardVersion CurrentVersion() const;
+    // Puts the board back the way it was in version, which can come from any
+    // game. Only chunks the board doesn't share with it are copied, and only
+    // tiles that look different are sent to the sink. With history on this
+    // is kept as a new version, so it can be undone like a press.
+    void RestoreVersion(BoardVersion const& version);
+
+#ifdef _WIN32
+    // Returns true if the file already held a board that was picked back up.
+    bool OpenBoardFile(std::wstring const& path);
+    void CloseBoardFile();
+#endif
+    void SaveSnapshot(std::vector<uint8_t>& snapshot) const;
+    void LoadSnapshot(uint8_t const* data, size_t size);
+    // A board file is already written through as it's played, so nothing
+    // is autosaved while one is open.
+    void SetAutosavePath(std::wstring const& path);
+    void Autosave();
+
+    int Width() const { return m_gameBoardWidth; }
+    int Height() const { return m_gameBoardHeight; }
+    IndexHelper& Indices() const { return *m_indexHelper; }
+    BoardHeader const& Header() const { return *m_header; }
+    MineState const* MineStates() const { return m_mineStates; }
+    int8_t const* NeighborCounts() const { return m_neighborCounts; }
+    bool IsGameOver() const { return m_header->outcome != GameOutcome::Playing; }
+    bool IsMine(int index) const;
+    // Counts the mines around (x, y) one neighbor at a time. Play uses the
+    // counts the bit board fills in up front; this is what they are checked
+    // against.
+    int GetSurroundingMineCount(int x, int y) const;
+    // Every tile that isn't a mine has been revealed.
+    bool CheckIfWon() const;
+
+    // FNV-1a over the tile states, counters and outcome. Two games that were
+    // played the same way hash the same no matter how they were stored.
+    uint64_t ComputeStateHash() const;
+
+    // Orders every mine by its ring around (centerX, centerY), starting with
+    // the center itself.
+    void ComputeMineRings(int centerX, int centerY, MineRings& rings) const;
+
+private:
+    // On the heap, or in the board file when one is open.
+    void CreateBoard(int width, int height);
+    // History and autosave both hold a copy of the board, which a mapped
+    // board may not fit in memory for.
+    bool IsKeepingHistory() const { return m_keepHistory && !m_board.IsMapped(); }
+    bool IsAutosaving() const { return m_autosaver && !m_board.IsMapped(); }
+    void BindBoard();
+    void GenerateFirstMines(int x, int y);
+    bool Sweep(int x, int y);
+    void Reveal(int index);
+    void CycleTile(int index);
+    TileUpdate MakeTileUpdate(int index) const;
+    void SendRevealedTileUpdates();
+    BoardVersion CaptureVersion() const;
+    void ResetHistory();
+    void KeepPressVersion(int markedIndex, bool minesGenerated);
+    void WritePressChunks(BoardVersion& version, int markedIndex, bool minesGenerated);
+    void KeepVersion(BoardVersion&& version);
+    void ApplyVersion(BoardVersion const& version, BoardVersion const* current);
+    void GenerateMines(int numMines, int excludeX, int excludeY);
+    void CountMines(MineBitBoard const& mines);
+    bool TestSpot(int x, int y) const;
+
+private:
+    int m_gameBoardWidth = 0;
+    int m_gameBoardHeight = 0;
+    std::unique_ptr<IndexHelper> m_indexHelper;
+    bool m_usePresetBoards = true;
+    PresetBoardKernels const* m_presetBoard = nullptr;
+
+    // The header holds the mine count, seed, counters and game state, so that
+    // a board backed by a file has everything it needs to be picked back up.
+    BoardStorage m_board;
+#ifdef _WIN32
+    std::wstring m_boardPath;
+#endif
+    BoardHeader* m_header = nullptr;
+    MineState* m_mineStates = nullptr;
+    int8_t* m_neighborCounts = nullptr;
+
+    SpanFloodFill m_floodFill;
+    bool m_parallelSweep = true;
+    ParallelFloodFill m_parallelFloodFill;
+    std::vector<TileSpan> m_revealedSpans;
+
+    // Without history the board is still kept as a version for the
+    // autosaver, updated a press at a time the same way.
+    std::unique_ptr<SnapshotAutosaver> m_autosaver;
+    BoardVersion m_autosaveVersion;
+
+    // Created the first time no guess mode is turned on, it owns threads.
+    bool m_noGuess = false;
+    std::unique_ptr<NoGuessGenerator> m_noGuessGenerator;
+
+    GameProfile* m_profile = nullptr;
+
+    TileUpdateSink* m_tileUpdateSink = nullptr;
+    std::vector<TileUpdate> m_tileUpdates;
+
+    // The version at m_historyPosition always matches the board.
+    bool m_keepHistory = false;
+    std::vector<BoardVersion> m_history;
+    size_t m_historyPosition = 0;
+    std::vector<size_t> m_dirtyChunks;
+};
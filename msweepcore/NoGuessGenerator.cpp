@@ -0,0 +1,169 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "RandomGenerator.h"
+#include "BoardStorage.h"
+#include "BoardVersion.h"
+#include "BoardSnapshot.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "NoGuessGenerator.h"
+#include "TileUpdates.h"
+#include "MinesweeperGame.h"
+
+NoGuessGenerator::NoGuessGenerator(int threadCount) : m_pool(threadCount)
+{
+    for (auto i = 0; i < m_pool.ThreadCount(); i++)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+std::optional<uint64_t> NoGuessGenerator::FindSeed(
+    int width,
+    int height,
+    int numMines,
+    int firstClickIndex,
+    uint64_t baseSeed,
+    uint64_t maxAttempts,
+    std::chrono::steady_clock::duration timeBudget)
+{
+    m_cancelled = false;
+    m_found = false;
+    m_attempts = 0;
+    m_timedOut = false;
+    m_deadline = std::chrono::steady_clock::now() + timeBudget;
+
+    std::mutex lock;
+    uint64_t foundSeed = 0;
+
+    // One search per worker, each with its own stream of candidate seeds.
+    RandomGenerator stream(baseSeed);
+    std::vector<std::function<void()>> tasks;
+    for (auto& worker : m_workers)
+    {
+        tasks.push_back([this, &worker, &lock, &foundSeed, stream, width, height, numMines, firstClickIndex, maxAttempts]()
+        {
+            auto random = stream;
+            while (!IsStopping() && m_attempts.fetch_add(1) < maxAttempts)
+            {
+                auto seed = random.Next();
+                if (IsSolvable(*worker, width, height, numMines, firstClickIndex, seed))
+                {
+                    std::unique_lock<std::mutex> foundLock(lock);
+                    if (!m_found)
+                    {
+                        foundSeed = seed;
+                        m_found = true;
+                    }
+                }
+            }
+        });
+        stream.Jump();
+    }
+    m_pool.Run(tasks);
+
+    // Every worker takes one attempt too many on its way out.
+    m_attempts = std::min(m_attempts.load(), maxAttempts);
+    if (!m_found)
+    {
+        return std::nullopt;
+    }
+    // A seed found as the clock ran out still counts.
+    m_timedOut = false;
+    return foundSeed;
+}
+
+bool NoGuessGenerator::IsStopping()
+{
+    if (m_found || m_cancelled || m_timedOut)
+    {
+        return true;
+    }
+    if (std::chrono::steady_clock::now() >= m_deadline)
+    {
+        m_timedOut = true;
+        return true;
+    }
+    return false;
+}
+
+bool NoGuessGenerator::IsSolvable(Worker& worker, int width, int height, int numMines, int firstClickIndex, uint64_t seed)
+{
+    worker.mines.Reset(width, height);
+    GenerateMineLayout(seed, numMines, firstClickIndex, worker.mines);
+
+    // Anything but an opening under the first click leaves a lone number,
+    // which is a guess straight away. This rejects most candidates before
+    // any counting happens.
+    auto firstX = firstClickIndex / height;
+    auto firstY = firstClickIndex % height;
+    for (auto x = std::max(firstX - 1, 0); x <= std::min(firstX + 1, width - 1); x++)
+    {
+        for (auto y = std::max(firstY - 1, 0); y <= std::min(firstY + 1, height - 1); y++)
+        {
+            if (worker.mines.Test(x, y))
+            {
+                return false;
+            }
+        }
+    }
+
+    auto tileCount = static_cast<size_t>(width) * height;
+    worker.neighborCounts.resize(tileCount);
+    worker.mines.ComputeNeighborCounts(worker.neighborCounts.data());
+    worker.mineStates.assign(tileCount, MineState::Empty);
+    auto mineStates = worker.mineStates.data();
+    auto neighborCounts = worker.neighborCounts.data();
+
+    auto unrevealedTiles = static_cast<int64_t>(tileCount);
+    auto fill = [&](int x, int y)
+    {
+        worker.revealedSpans.clear();
+        worker.floodFill.Fill(mineStates, neighborCounts, width, height, x, y, worker.revealedSpans);
+        for (auto& span : worker.revealedSpans)
+        {
+            unrevealedTiles -= span.length;
+        }
+    };
+    fill(firstX, firstY);
+
+    // Play it out, sweeping every tile the solver proves safe, until only the
+    // mines are left or the solver is stuck.
+    while (unrevealedTiles > numMines)
+    {
+        if (IsStopping())
+        {
+            return false;
+        }
+
+        worker.safeTiles.clear();
+        worker.mineTiles.clear();
+        worker.solver.Solve(width, height, mineStates, neighborCounts, false, worker.safeTiles, worker.mineTiles);
+        if (worker.safeTiles.empty())
+        {
+            return false;
+        }
+
+        for (auto index : worker.safeTiles)
+        {
+            // An opening swept earlier in this pass may already have revealed it.
+            if (mineStates[index] == MineState::Revealed)
+            {
+                continue;
+            }
+
+            if (neighborCounts[index] == 0)
+            {
+                fill(index / height, index % height);
+            }
+            else
+            {
+                mineStates[index] = MineState::Revealed;
+                unrevealedTiles--;
+            }
+        }
+    }
+    return true;
+}
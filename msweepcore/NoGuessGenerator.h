@@ -0,0 +1,70 @@
+#pragma once
+
+// Finds mine layouts that can be solved without guessing. A layout is fully
+// determined by a seed and the first click (see GenerateMineLayout), so the
+// search is for a seed: every thread draws candidates from its own jumped
+// RandomGenerator stream, plays each layout out with a MineSolver from the
+// opening around the first click, and the first seed whose board gets
+// cleared wins. Games made from the seed stay reproducible, since snapshots
+// and logs only ever store the seed that was found.
+class NoGuessGenerator
+{
+public:
+    static const uint64_t DefaultMaxAttempts = 1 << 20;
+    // The search runs inside the first sweep, so by default it gives up
+    // before the player would notice the press hanging.
+    static constexpr int DefaultTimeBudgetMilliseconds = 250;
+
+    // A threadCount of 0 uses one thread per hardware thread.
+    NoGuessGenerator(int threadCount = 0);
+    ~NoGuessGenerator() {}
+
+    int ThreadCount() const { return m_pool.ThreadCount(); }
+
+    // Returns the first seed found that can be solved without guessing when
+    // the first click is firstClickIndex. Returns nothing if the search is
+    // cancelled, runs past timeBudget or maxAttempts candidates were all
+    // rejected, in which case the caller is expected to fall back to a
+    // regular layout.
+    std::optional<uint64_t> FindSeed(
+        int width,
+        int height,
+        int numMines,
+        int firstClickIndex,
+        uint64_t baseSeed,
+        uint64_t maxAttempts = DefaultMaxAttempts,
+        std::chrono::steady_clock::duration timeBudget = std::chrono::milliseconds(DefaultTimeBudgetMilliseconds));
+
+    // Makes a FindSeed in progress on another thread give up.
+    void Cancel() { m_cancelled = true; }
+
+    // How many candidates the last FindSeed checked over every thread.
+    uint64_t Attempts() const { return m_attempts; }
+    // Whether the last FindSeed gave up because it ran out of time.
+    bool TimedOut() const { return m_timedOut; }
+
+private:
+    struct Worker
+    {
+        MineBitBoard mines;
+        std::vector<MineState> mineStates;
+        std::vector<int8_t> neighborCounts;
+        SpanFloodFill floodFill;
+        std::vector<TileSpan> revealedSpans;
+        MineSolver solver;
+        std::vector<int> safeTiles;
+        std::vector<int> mineTiles;
+    };
+
+    bool IsSolvable(Worker& worker, int width, int height, int numMines, int firstClickIndex, uint64_t seed);
+    bool IsStopping();
+
+private:
+    WorkStealingPool m_pool;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool> m_cancelled{ false };
+    std::atomic<bool> m_found{ false };
+    std::atomic<uint64_t> m_attempts{ 0 };
+    std::atomic<bool> m_timedOut{ false };
+    std::chrono::steady_clock::time_point m_deadline;
+};
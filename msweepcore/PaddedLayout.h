@@ -0,0 +1,67 @@
+#pragma once
+
+// The order of a copy of the board that has a border of sentinel tiles around
+// it and whose columns are padded out to a power of two. Every neighbor is a
+// fixed offset from its tile, even along the edges, and going between padded
+// indices and coordinates is a shift and a mask instead of a divide.
+// Coordinates are the board's own, the border and padding never show.
+//
+// The columns run into each other: the padding at the end of one column is
+// the border at the start of the next, so a column holds at least height +
+// border tiles. The board itself stays in IndexHelper order, this is only for
+// kernels that keep their own copy of it.
+struct PaddedLayout
+{
+    int width = 0;
+    int height = 0;
+    int border = 0;
+    int shift = 0;
+    int mask = 0;
+
+    PaddedLayout() {}
+
+    PaddedLayout(int width, int height, int border)
+    {
+        this->width = width;
+        this->height = height;
+        this->border = border;
+        shift = 0;
+        while ((1 << shift) < height + border)
+        {
+            shift++;
+        }
+        mask = (1 << shift) - 1;
+    }
+
+    int Pitch() const
+    {
+        return 1 << shift;
+    }
+
+    // Enough tiles for every padded index, borders included. The last
+    // column's border runs past its slot by up to border tiles.
+    size_t TileCount() const
+    {
+        return (static_cast<size_t>(width + border * 2) << shift) + border;
+    }
+
+    int ComputeIndex(int x, int y) const
+    {
+        return ((x + border) << shift) + y + border;
+    }
+
+    int ComputeXFromIndex(int index) const
+    {
+        return (index >> shift) - border;
+    }
+
+    int ComputeYFromIndex(int index) const
+    {
+        return (index & mask) - border;
+    }
+
+    int NeighborOffset(int offsetX, int offsetY) const
+    {
+        return offsetX * Pitch() + offsetY;
+    }
+};
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "SpanFloodFill.h"
+#include "ParallelFloodFill.h"
+#include "WorkStealingPool.h"
+
+ParallelFloodFill::ParallelFloodFill(int threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_threadCount = threadCount;
+}
+
+ParallelFloodFill::~ParallelFloodFill()
+{
+}
+
+void ParallelFloodFill::Fill(
+    MineState* mineStates,
+    int8_t const* neighborCounts,
+    int width,
+    int height,
+    int x,
+    int y,
+    std::vector<TileSpan>& revealedSpans)
+{
+    ResetStripes(width);
+    if (!m_pool)
+    {
+        m_pool = std::make_unique<WorkStealingPool>(m_threadCount);
+    }
+    m_board = { mineStates, neighborCounts, width, height };
+
+    // Scanning the clicked tile by itself seeds the flood in its stripe.
+    m_stripes[FindStripe(x)].incomingRanges.push_back({ x, y, y });
+
+    std::vector<Stripe*> activeStripes;
+    while (true)
+    {
+        activeStripes.clear();
+        for (auto& stripe : m_stripes)
+        {
+            if (!stripe.incomingRanges.empty())
+            {
+                activeStripes.push_back(&stripe);
+            }
+        }
+
+        if (activeStripes.empty())
+        {
+            break;
+        }
+
+        // Stripes only ever write to their own columns, so they can all run
+        // at once. A lone stripe isn't worth waking the pool for.
+        if (activeStripes.size() == 1)
+        {
+            FillStripe(*activeStripes[0]);
+        }
+        else
+        {
+            for (auto stripe : activeStripes)
+            {
+                m_tasks.push_back([this, stripe]() { FillStripe(*stripe); });
+            }
+            m_pool->Run(m_tasks);
+        }
+
+        // Hand the ranges that crossed a border to the stripes that own them.
+        for (auto stripe : activeStripes)
+        {
+            stripe->incomingRanges.clear();
+        }
+        for (auto stripe : activeStripes)
+        {
+            for (auto& range : stripe->outgoingRanges)
+            {
+                m_stripes[FindStripe(range.x)].incomingRanges.push_back(range);
+            }
+            stripe->outgoingRanges.clear();
+        }
+    }
+
+    m_board = {};
+    for (auto& stripe : m_stripes)
+    {
+        revealedSpans.insert(revealedSpans.end(), stripe.revealedSpans.begin(), stripe.revealedSpans.end());
+    }
+}
+
+void ParallelFloodFill::ResetStripes(int width)
+{
+    auto stripeCount = std::min(m_threadCount, width);
+    if (m_stripes.size() != static_cast<size_t>(stripeCount))
+    {
+        m_stripes = std::vector<Stripe>(stripeCount);
+    }
+
+    for (auto i = 0; i < stripeCount; i++)
+    {
+        auto& stripe = m_stripes[i];
+        stripe.firstColumn = static_cast<int>(static_cast<int64_t>(width) * i / stripeCount);
+        stripe.lastColumn = static_cast<int>(static_cast<int64_t>(width) * (i + 1) / stripeCount) - 1;
+        stripe.incomingRanges.clear();
+        stripe.outgoingRanges.clear();
+        stripe.revealedSpans.clear();
+    }
+}
+
+void ParallelFloodFill::FillStripe(Stripe& stripe)
+{
+    stripe.floodFill.FillStripe(
+        m_board.mineStates,
+        m_board.neighborCounts,
+        m_board.width,
+        m_board.height,
+        stripe.firstColumn,
+        stripe.lastColumn,
+        stripe.incomingRanges,
+        stripe.revealedSpans,
+        stripe.outgoingRanges);
+}
+
+int ParallelFloodFill::FindStripe(int x) const
+{
+    auto stripe = std::upper_bound(m_stripes.begin(), m_stripes.end(), x, [](int x, Stripe const& stripe)
+    {
+        return x < stripe.firstColumn;
+    });
+    return static_cast<int>(stripe - m_stripes.begin()) - 1;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+class WorkStealingPool;
+
+// Floods very large openings on several threads. The board is split into
+// stripes of whole columns and each stripe is filled by its own SpanFloodFill.
+// When a stripe's fill reaches a column owned by another stripe it hands the
+// range over, and the stripes keep exchanging ranges in rounds until none are
+// left. The revealed tiles are the same as a single SpanFloodFill::Fill.
+// The rounds run on a WorkStealingPool that is started by the first fill and
+// kept for the rest, so a round costs a wake up rather than a thread each.
+class ParallelFloodFill
+{
+public:
+    // A threadCount of 0 uses one thread per hardware thread.
+    ParallelFloodFill(int threadCount = 0);
+    ~ParallelFloodFill();
+
+    int ThreadCount() const { return m_threadCount; }
+
+    void Fill(
+        MineState* mineStates,
+        int8_t const* neighborCounts,
+        int width,
+        int height,
+        int x,
+        int y,
+        std::vector<TileSpan>& revealedSpans);
+
+private:
+    struct Stripe
+    {
+        int firstColumn;
+        int lastColumn;
+        SpanFloodFill floodFill;
+        std::vector<ColumnRange> incomingRanges;
+        std::vector<ColumnRange> outgoingRanges;
+        std::vector<TileSpan> revealedSpans;
+    };
+
+    struct Board
+    {
+        MineState* mineStates;
+        int8_t const* neighborCounts;
+        int width;
+        int height;
+    };
+
+    void ResetStripes(int width);
+    int FindStripe(int x) const;
+    void FillStripe(Stripe& stripe);
+
+private:
+    int m_threadCount;
+    std::vector<Stripe> m_stripes;
+    std::unique_ptr<WorkStealingPool> m_pool;
+    std::vector<std::function<void()>> m_tasks;
+    Board m_board = {};
+};
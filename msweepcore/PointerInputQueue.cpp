@@ -0,0 +1,26 @@
+#include "pch.h"
+#include "PointerInputQueue.h"
+
+void PointerInputQueue::Move(float x, float y)
+{
+    if (!m_inputs.empty() && m_inputs.back().kind == PointerInputKind::Move)
+    {
+        m_inputs.back().x = x;
+        m_inputs.back().y = y;
+        m_coalescedMoves++;
+        return;
+    }
+
+    m_inputs.push_back({ PointerInputKind::Move, x, y, false, false });
+}
+
+void PointerInputQueue::Press(bool isRightButton, bool isEraser)
+{
+    m_inputs.push_back({ PointerInputKind::Press, 0.0f, 0.0f, isRightButton, isEraser });
+}
+
+void PointerInputQueue::Take(std::vector<PointerInput>& inputs)
+{
+    inputs.clear();
+    m_inputs.swap(inputs);
+}
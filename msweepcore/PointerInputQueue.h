@@ -0,0 +1,45 @@
+#pragma once
+
+enum class PointerInputKind : uint8_t
+{
+    Move,
+    Press,
+};
+
+struct PointerInput
+{
+    PointerInputKind kind;
+    // Where the pointer moved to, only set for moves.
+    float x;
+    float y;
+    // Only set for presses.
+    bool isRightButton;
+    bool isEraser;
+};
+
+// Holds pointer input until the host's next frame. A move that follows
+// another move replaces it, so a burst from a high rate mouse or pen becomes
+// a single move, but presses are never merged and keep their order. Each
+// press is handled after the latest move that came before it, so it lands on
+// the tile the pointer was over when it was pressed.
+class PointerInputQueue
+{
+public:
+    PointerInputQueue() {}
+    ~PointerInputQueue() {}
+
+    void Move(float x, float y);
+    void Press(bool isRightButton, bool isEraser);
+
+    bool IsEmpty() const { return m_inputs.empty(); }
+    // Swaps the queued input into inputs and leaves the queue empty. Both
+    // buffers keep their capacity, so a steady stream doesn't allocate.
+    void Take(std::vector<PointerInput>& inputs);
+
+    // How many moves have been replaced by a later one.
+    uint64_t CoalescedMoves() const { return m_coalescedMoves; }
+
+private:
+    std::vector<PointerInput> m_inputs;
+    uint64_t m_coalescedMoves = 0;
+};
@@ -0,0 +1,29 @@
+#include "pch.h"
+#include "RandomGenerator.h"
+#include "SpanFloodFill.h"
+#include "PresetBoard.h"
+
+template <typename Board>
+static constexpr PresetBoardKernels MakePresetBoardKernels()
+{
+    return { Board::Width, Board::Height, &Board::GenerateNeighborCounts, &Board::FloodFill };
+}
+
+static const PresetBoardKernels PresetBoards[] =
+{
+    MakePresetBoardKernels<PresetBoard<9, 9>>(),
+    MakePresetBoardKernels<PresetBoard<16, 16>>(),
+    MakePresetBoardKernels<PresetBoard<30, 16>>(),
+};
+
+PresetBoardKernels const* FindPresetBoard(int width, int height)
+{
+    for (auto& board : PresetBoards)
+    {
+        if (board.width == width && board.height == height)
+        {
+            return &board;
+        }
+    }
+    return nullptr;
+}
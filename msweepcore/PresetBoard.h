@@ -0,0 +1,176 @@
+#pragma once
+
+// Floyd's sampling behind GenerateMineLayout: picks numMines distinct tiles
+// out of tileCount, never excludeIndex, with one random number each. The
+// excluded tile is skipped by sampling from one fewer slot and shifting the
+// slots at or past it up by one. Every board type goes through this, so a
+// seed and a first click give the same layout however the board is stored.
+template <typename IsMine, typename SetMine>
+void SampleMineLayout(uint64_t seed, int numMines, int excludeIndex, int tileCount, IsMine&& isMine, SetMine&& setMine)
+{
+    RandomGenerator random(seed);
+    auto slots = tileCount - 1;
+    auto slotToIndex = [excludeIndex](int slot) { return slot < excludeIndex ? slot : slot + 1; };
+    for (auto slot = slots - numMines; slot < slots; slot++)
+    {
+        auto index = slotToIndex(static_cast<int>(random.NextBelow(slot + 1)));
+        if (isMine(index))
+        {
+            // Already picked, take the newest slot instead. It can't have been picked yet.
+            index = slotToIndex(slot);
+        }
+        setMine(index);
+    }
+}
+
+// The tiles around one tile of a preset board, by index.
+struct PresetNeighborList
+{
+    uint8_t count;
+    std::array<uint16_t, 8> indices;
+};
+
+template <int Width, int Height>
+constexpr std::array<PresetNeighborList, Width * Height> MakePresetNeighbors()
+{
+    std::array<PresetNeighborList, Width * Height> neighbors = {};
+    for (auto x = 0; x < Width; x++)
+    {
+        for (auto y = 0; y < Height; y++)
+        {
+            auto& list = neighbors[x * Height + y];
+            for (auto dx = -1; dx <= 1; dx++)
+            {
+                for (auto dy = -1; dy <= 1; dy++)
+                {
+                    auto nx = x + dx;
+                    auto ny = y + dy;
+                    if ((dx != 0 || dy != 0) && nx >= 0 && nx < Width && ny >= 0 && ny < Height)
+                    {
+                        list.indices[list.count++] = static_cast<uint16_t>(nx * Height + ny);
+                    }
+                }
+            }
+        }
+    }
+    return neighbors;
+}
+
+// A board whose size is known at compile time, for the classic presets. The
+// mines go into a std::array with a ring of empty tiles around it, so the
+// eight neighbor offsets are constants and every count is eight loads added
+// up with no bounds checks. Index math divides by a constant height, which
+// compiles to a multiply. Sweeps walk a constexpr table of each tile's
+// neighbors with a stack that lives on the stack.
+template <int BoardWidth, int BoardHeight>
+class PresetBoard
+{
+public:
+    static constexpr int Width = BoardWidth;
+    static constexpr int Height = BoardHeight;
+    static constexpr int TileCount = Width * Height;
+
+    // Same as MineBitBoard::ComputeNeighborCounts on the layout
+    // GenerateMineLayout would give.
+    static void GenerateNeighborCounts(uint64_t seed, int numMines, int excludeIndex, int8_t* neighborCounts)
+    {
+        std::array<uint8_t, PaddedTileCount> mines = {};
+        SampleMineLayout(seed, numMines, excludeIndex, TileCount,
+            [&mines](int index) { return mines[PaddedIndex(index)] != 0; },
+            [&mines](int index) { mines[PaddedIndex(index)] = 1; });
+
+        for (auto x = 0; x < Width; x++)
+        {
+            auto padded = (x + 1) * PaddedHeight + 1;
+            for (auto y = 0; y < Height; y++, padded++)
+            {
+                auto count = CountNeighbors(mines, padded, std::make_index_sequence<PaddedOffsets.size()>());
+                neighborCounts[x * Height + y] = mines[padded] ? -1 : static_cast<int8_t>(count);
+            }
+        }
+    }
+
+    // Same as SpanFloodFill::Fill, though the spans can come in a different
+    // order and split differently.
+    static void FloodFill(MineState* mineStates, int8_t const* neighborCounts, int x, int y, std::vector<TileSpan>& revealedSpans)
+    {
+        std::array<uint16_t, TileCount> stack;
+        auto stackSize = 0;
+        auto start = x * Height + y;
+        Reveal(mineStates, start, revealedSpans);
+        stack[stackSize++] = static_cast<uint16_t>(start);
+        while (stackSize > 0)
+        {
+            auto& neighbors = Neighbors[stack[--stackSize]];
+            for (auto i = 0; i < neighbors.count; i++)
+            {
+                auto neighbor = neighbors.indices[i];
+                if (mineStates[neighbor] != MineState::Empty)
+                {
+                    continue;
+                }
+                Reveal(mineStates, neighbor, revealedSpans);
+                // A tile's neighbors only open up if it has no mines around it.
+                if (neighborCounts[neighbor] == 0)
+                {
+                    stack[stackSize++] = neighbor;
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int PaddedHeight = Height + 2;
+    static constexpr int PaddedTileCount = (Width + 2) * PaddedHeight;
+    static constexpr std::array<int, 8> PaddedOffsets =
+    {
+        -PaddedHeight - 1, -PaddedHeight, -PaddedHeight + 1,
+        -1, 1,
+        PaddedHeight - 1, PaddedHeight, PaddedHeight + 1,
+    };
+
+    static constexpr auto Neighbors = MakePresetNeighbors<Width, Height>();
+
+    static constexpr int PaddedIndex(int index)
+    {
+        return (index / Height + 1) * PaddedHeight + index % Height + 1;
+    }
+
+    template <size_t... Offsets>
+    static int CountNeighbors(std::array<uint8_t, PaddedTileCount> const& mines, int padded, std::index_sequence<Offsets...>)
+    {
+        return (mines[padded + PaddedOffsets[Offsets]] + ...);
+    }
+
+    static void Reveal(MineState* mineStates, int index, std::vector<TileSpan>& revealedSpans)
+    {
+        mineStates[index] = MineState::Revealed;
+        auto x = index / Height;
+        auto y = index % Height;
+        // Tiles revealed one after another down a column share a span.
+        if (!revealedSpans.empty())
+        {
+            auto& last = revealedSpans.back();
+            if (last.x == x && last.y + last.length == y)
+            {
+                last.length++;
+                return;
+            }
+        }
+        revealedSpans.push_back({ x, y, 1 });
+    }
+};
+
+// A preset's kernels, for a game that only knows its size at run time.
+struct PresetBoardKernels
+{
+    int width;
+    int height;
+    void (*generateNeighborCounts)(uint64_t seed, int numMines, int excludeIndex, int8_t* neighborCounts);
+    void (*floodFill)(MineState* mineStates, int8_t const* neighborCounts, int x, int y, std::vector<TileSpan>& revealedSpans);
+};
+
+// The kernels for a board of this size, or null if it isn't a preset. The
+// presets are the classic 9x9, 16x16 and 30x16 boards, whatever their
+// mine counts.
+PresetBoardKernels const* FindPresetBoard(int width, int height);
@@ -0,0 +1,850 @@
+#include "pch.h"
+#include "MineSolver.h"
+#include "WorkStealingPool.h"
+#include "RandomGenerator.h"
+#include "ProbabilitySolver.h"
+
+namespace
+{
+    const int NeighborX[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+    const int NeighborY[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+
+    // Enough to enumerate the components of a typical stuck expert board
+    // several times over, and still finish well inside a frame.
+    const uint64_t DefaultEnumerationLimit = 1ull << 21;
+    // Components with at least this many tiles are split into several tasks
+    // by fixing their first few tiles, so one big component can't leave the
+    // other threads idle.
+    const int SplitMinimumTiles = 16;
+    const int MaximumSplitBits = 8;
+    // Every estimated component runs the same number of probes with the same
+    // seeds, so estimates don't depend on the thread count. Each task gets
+    // about ProbeSteps tile assignments.
+    const int ProbeTasks = 4;
+    const int ProbeSteps = 1 << 17;
+    // Every task keeps its own tile weights, a row of doubles per mine count
+    // a component can hold. A component is enumerated in fewer tasks, then
+    // probed, then given up on, rather than go past this many between its
+    // tasks.
+    const size_t MaximumTileWeights = 1 << 22;
+
+    int FindRoot(std::vector<int>& parents, int tile)
+    {
+        while (parents[tile] != tile)
+        {
+            parents[tile] = parents[parents[tile]];
+            tile = parents[tile];
+        }
+        return tile;
+    }
+
+    double LogBinomial(int n, int k)
+    {
+        return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+    }
+
+    void Convolve(std::vector<double> const& first, std::vector<double> const& second, std::vector<double>& result)
+    {
+        result.assign(first.size() + second.size() - 1, 0.0);
+        for (size_t i = 0; i < first.size(); i++)
+        {
+            if (first[i] == 0.0)
+            {
+                continue;
+            }
+            for (size_t j = 0; j < second.size(); j++)
+            {
+                result[i + j] += first[i] * second[j];
+            }
+        }
+
+        // Only ratios matter, so keep the largest weight at 1 to stay clear
+        // of underflow when there are many components.
+        auto largest = *std::max_element(result.begin(), result.end());
+        if (largest > 0.0)
+        {
+            for (auto& value : result)
+            {
+                value /= largest;
+            }
+        }
+    }
+
+    // The depth first search over one component. Tiles are visited in the
+    // component's order, and a branch is cut as soon as any constraint has
+    // too many mines or too few tiles left to reach its count. Components can
+    // have thousands of tiles, so the search keeps its own stack: values[t]
+    // is the value tile t holds while it's on the path, or -1.
+    struct Enumeration
+    {
+        int tileCount;
+        int minMines;
+        int maxMines;
+        int const* tileConstraintStarts;
+        int const* constraintIndices;
+        int8_t const* constraintMines;
+        uint32_t prefix;
+        int prefixLength;
+        uint64_t limit;
+        std::atomic<uint64_t>* sharedNodes;
+        std::atomic<bool>* aborted;
+
+        std::vector<int> mines;
+        std::vector<int> unassigned;
+        std::vector<int> mineTiles;
+        std::vector<int8_t> values;
+        std::vector<double>* weights;
+        std::vector<double>* tileWeights;
+        uint64_t nodes = 0;
+
+        // Returns false once the component has used up its nodes.
+        bool Charge()
+        {
+            // The shared count is charged in blocks, up front.
+            if ((nodes++ & 4095) == 0)
+            {
+                if (aborted->load(std::memory_order_relaxed) || sharedNodes->fetch_add(4096, std::memory_order_relaxed) + 4096 > limit)
+                {
+                    aborted->store(true, std::memory_order_relaxed);
+                }
+            }
+            return !aborted->load(std::memory_order_relaxed);
+        }
+
+        // Adds value to every constraint of tile, and returns whether they
+        // can all still be met.
+        bool Apply(int tile, int value, int direction)
+        {
+            auto valid = true;
+            for (auto i = tileConstraintStarts[tile]; i < tileConstraintStarts[tile + 1]; i++)
+            {
+                auto constraint = constraintIndices[i];
+                unassigned[constraint] -= direction;
+                mines[constraint] += value * direction;
+                if (mines[constraint] > constraintMines[constraint] ||
+                    mines[constraint] + unassigned[constraint] < constraintMines[constraint])
+                {
+                    valid = false;
+                }
+            }
+            return valid;
+        }
+
+        void CountLeaf()
+        {
+            if (weights->empty())
+            {
+                auto rows = static_cast<size_t>(maxMines - minMines + 1);
+                weights->assign(rows, 0.0);
+                tileWeights->assign(rows * tileCount, 0.0);
+            }
+            auto row = mineTiles.size() - minMines;
+            (*weights)[row] += 1.0;
+            auto tileRow = tileWeights->data() + row * tileCount;
+            for (auto mineTile : mineTiles)
+            {
+                tileRow[mineTile] += 1.0;
+            }
+        }
+
+        void Run()
+        {
+            values.assign(tileCount, -1);
+            if (!Charge())
+            {
+                return;
+            }
+
+            auto tile = 0;
+            while (tile >= 0)
+            {
+                if (tile == tileCount)
+                {
+                    CountLeaf();
+                    tile--;
+                    continue;
+                }
+
+                // Take back the value the tile had, and move on to the next.
+                auto value = values[tile];
+                if (value >= 0)
+                {
+                    Apply(tile, value, -1);
+                    if (value)
+                    {
+                        mineTiles.pop_back();
+                    }
+                }
+                value++;
+                if (tile < prefixLength)
+                {
+                    // Tiles in the prefix only take the prefix's value.
+                    auto fixed = static_cast<int>((prefix >> tile) & 1);
+                    value = value <= fixed ? fixed : 2;
+                }
+                if (value > 1)
+                {
+                    values[tile] = -1;
+                    tile--;
+                    continue;
+                }
+
+                values[tile] = static_cast<int8_t>(value);
+                if (value)
+                {
+                    mineTiles.push_back(tile);
+                }
+                // A dead end is taken back on the next pass over the same tile.
+                if (Apply(tile, value, 1))
+                {
+                    if (!Charge())
+                    {
+                        return;
+                    }
+                    tile++;
+                }
+            }
+        }
+    };
+}
+
+ProbabilitySolver::ProbabilitySolver(int threadCount) : m_pool(threadCount)
+{
+    m_enumerationLimit = DefaultEnumerationLimit;
+}
+
+bool ProbabilitySolver::Compute(
+    int width,
+    int height,
+    MineState const* mineStates,
+    int8_t const* neighborCounts,
+    int numMines,
+    bool trustFlags,
+    std::vector<double>& probabilities)
+{
+    m_usedEstimate = false;
+
+    // Everything that can be proven is left out of the search.
+    m_safeTiles.clear();
+    m_mineTiles.clear();
+    m_solver.Solve(width, height, mineStates, neighborCounts, trustFlags, m_safeTiles, m_mineTiles);
+    if (!BuildComponents(width, height, mineStates, neighborCounts))
+    {
+        return false;
+    }
+
+    // Enumerate every component, splitting the big ones so that the pool
+    // has something to steal.
+    auto splitBits = 0;
+    while (splitBits < MaximumSplitBits && (1 << splitBits) < m_pool.ThreadCount() * 4 && m_pool.ThreadCount() > 1)
+    {
+        splitBits++;
+    }
+
+    std::vector<ComponentResult> results;
+    for (auto& component : m_components)
+    {
+        auto tileCount = static_cast<int>(component->tiles.size());
+        auto tileWeights = static_cast<size_t>(component->maxMines - component->minMines + 1) * tileCount;
+        auto prefixLength = tileCount >= SplitMinimumTiles ? splitBits : 0;
+        while (prefixLength > 0 && (tileWeights << prefixLength) > MaximumTileWeights)
+        {
+            prefixLength--;
+        }
+        if (tileWeights > MaximumTileWeights)
+        {
+            // Straight to estimating, without allocating a thing.
+            component->aborted = true;
+            continue;
+        }
+        for (uint32_t prefix = 0; prefix < (1u << prefixLength); prefix++)
+        {
+            results.push_back({ component.get(), prefix, prefixLength, 0, {}, {}, 0 });
+        }
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (auto& result : results)
+    {
+        tasks.push_back([this, &result]() { Enumerate(result); });
+    }
+    m_pool.Run(tasks);
+
+    for (auto& component : m_components)
+    {
+        component->estimated = component->aborted;
+    }
+    for (auto& result : results)
+    {
+        if (!result.component->estimated)
+        {
+            MergeResult(result);
+        }
+    }
+
+    // Estimate whatever was too big to enumerate.
+    results.clear();
+    for (size_t i = 0; i < m_components.size(); i++)
+    {
+        auto& component = *m_components[i];
+        auto tileWeights = static_cast<size_t>(component.maxMines - component.minMines + 1) * component.tiles.size();
+        if (component.estimated)
+        {
+            m_usedEstimate = true;
+            if (tileWeights * ProbeTasks > MaximumTileWeights)
+            {
+                // Left with no weights, so it's treated like the interior.
+                continue;
+            }
+            for (uint32_t task = 0; task < ProbeTasks; task++)
+            {
+                results.push_back({ m_components[i].get(), 0, 0, i * ProbeTasks + task, {}, {}, 0 });
+            }
+        }
+    }
+    for (auto& result : results)
+    {
+        tasks.push_back([this, &result]() { Probe(result); });
+    }
+    m_pool.Run(tasks);
+    for (auto& result : results)
+    {
+        MergeResult(result);
+    }
+
+    auto remainingMines = numMines - m_knownMines;
+    if (remainingMines < 0)
+    {
+        return false;
+    }
+
+    // A component whose probes all ran into dead ends tells us nothing, so
+    // its tiles are treated like the interior.
+    std::vector<Component*> components;
+    std::vector<Component*> unknownComponents;
+    auto interiorCount = static_cast<int>(m_interiorTiles.size());
+    for (auto& component : m_components)
+    {
+        auto largest = component->weights.empty() ? 0.0 : *std::max_element(component->weights.begin(), component->weights.end());
+        if (largest == 0.0)
+        {
+            if (!component->estimated)
+            {
+                return false;
+            }
+            interiorCount += static_cast<int>(component->tiles.size());
+            unknownComponents.push_back(component.get());
+            continue;
+        }
+
+        for (auto& value : component->weights)
+        {
+            value /= largest;
+        }
+        for (auto& value : component->tileWeights)
+        {
+            value /= largest;
+        }
+        components.push_back(component.get());
+    }
+
+    // prefixes[c] holds the weights of every total for the components before
+    // c, suffixes[c] for c and every component after it. Like the weights of
+    // a single component they start at the fewest mines the components can
+    // hold, so the full frontier's totals start at frontierMinimum.
+    auto frontierMinimum = 0;
+    for (auto component : components)
+    {
+        frontierMinimum += component->minMines;
+    }
+    std::vector<std::vector<double>> prefixes(components.size() + 1);
+    std::vector<std::vector<double>> suffixes(components.size() + 1);
+    prefixes[0] = { 1.0 };
+    suffixes[components.size()] = { 1.0 };
+    for (size_t c = 0; c < components.size(); c++)
+    {
+        Convolve(prefixes[c], components[c]->weights, prefixes[c + 1]);
+    }
+    for (auto c = components.size(); c > 0; c--)
+    {
+        Convolve(suffixes[c], components[c - 1]->weights, suffixes[c - 1]);
+    }
+
+    // interiorWeights[K] is the number of ways to put the mines the frontier
+    // doesn't use into the interior, when the frontier uses frontierMinimum
+    // + K of them.
+    auto frontierMaximum = static_cast<int>(prefixes[components.size()].size()) - 1;
+    std::vector<double> interiorWeights(frontierMaximum + 1, 0.0);
+    auto largestLog = -std::numeric_limits<double>::infinity();
+    for (auto total = 0; total <= frontierMaximum; total++)
+    {
+        auto interiorMines = remainingMines - frontierMinimum - total;
+        if (interiorMines >= 0 && interiorMines <= interiorCount)
+        {
+            largestLog = std::max(largestLog, LogBinomial(interiorCount, interiorMines));
+        }
+    }
+    for (auto total = 0; total <= frontierMaximum; total++)
+    {
+        auto interiorMines = remainingMines - frontierMinimum - total;
+        if (interiorMines >= 0 && interiorMines <= interiorCount)
+        {
+            interiorWeights[total] = std::exp(LogBinomial(interiorCount, interiorMines) - largestLog);
+        }
+    }
+
+    auto tileCount = static_cast<size_t>(width) * height;
+    probabilities.assign(tileCount, 0.0);
+    auto& layout = m_solver.Layout();
+    for (auto x = 0; x < width; x++)
+    {
+        auto padded = layout.ComputeIndex(x, 0);
+        for (auto y = 0; y < height; y++)
+        {
+            if (m_solver.PaddedTile(padded + y) == SolverTile::Mine)
+            {
+                probabilities[x * height + y] = 1.0;
+            }
+        }
+    }
+
+    std::vector<double> others;
+    std::vector<double> otherWeights;
+    for (size_t c = 0; c < components.size(); c++)
+    {
+        auto& component = *components[c];
+        auto componentTiles = component.tiles.size();
+
+        // otherWeights[k] weighs the component having minMines + k mines by
+        // every way the other components and the interior can hold the rest.
+        Convolve(prefixes[c], suffixes[c + 1], others);
+        otherWeights.assign(component.weights.size(), 0.0);
+        auto total = 0.0;
+        for (size_t k = 0; k < component.weights.size(); k++)
+        {
+            for (size_t other = 0; other < others.size() && k + other < interiorWeights.size(); other++)
+            {
+                otherWeights[k] += others[other] * interiorWeights[k + other];
+            }
+            total += component.weights[k] * otherWeights[k];
+        }
+        if (total == 0.0)
+        {
+            return false;
+        }
+
+        for (size_t t = 0; t < componentTiles; t++)
+        {
+            auto weight = 0.0;
+            for (size_t k = 0; k < component.weights.size(); k++)
+            {
+                weight += component.tileWeights[k * componentTiles + t] * otherWeights[k];
+            }
+            probabilities[component.tiles[t]] = weight / total;
+        }
+    }
+
+    auto& frontier = prefixes[components.size()];
+    auto total = 0.0;
+    auto interiorMines = 0.0;
+    for (auto k = 0; k <= frontierMaximum; k++)
+    {
+        total += frontier[k] * interiorWeights[k];
+        interiorMines += frontier[k] * interiorWeights[k] * (remainingMines - frontierMinimum - k);
+    }
+    if (total == 0.0)
+    {
+        return false;
+    }
+
+    if (interiorCount > 0)
+    {
+        auto interiorProbability = interiorMines / total / interiorCount;
+        for (auto index : m_interiorTiles)
+        {
+            probabilities[index] = interiorProbability;
+        }
+        for (auto component : unknownComponents)
+        {
+            for (auto index : component->tiles)
+            {
+                probabilities[index] = interiorProbability;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool ProbabilitySolver::BuildComponents(int width, int height, MineState const* mineStates, int8_t const* neighborCounts)
+{
+    m_components.clear();
+    m_interiorTiles.clear();
+    m_knownMines = 0;
+
+    auto tileCount = static_cast<size_t>(width) * height;
+    std::vector<int> frontierIds(tileCount, -1);
+    std::vector<int> frontierTiles;
+
+    // The solver's padded copy has Safe tiles all around the board, so
+    // neighbors are fixed offsets and the ones off the board are skipped
+    // without a bounds check. Only tiles on the board are ever Mine or
+    // Unknown, and the same offsets in board order reach them.
+    auto& layout = m_solver.Layout();
+    int paddedOffsets[8];
+    int offsets[8];
+    for (auto k = 0; k < 8; k++)
+    {
+        paddedOffsets[k] = layout.NeighborOffset(NeighborX[k], NeighborY[k]);
+        offsets[k] = NeighborX[k] * height + NeighborY[k];
+    }
+    for (auto x = 0; x < width; x++)
+    {
+        auto padded = layout.ComputeIndex(x, 0);
+        for (auto y = 0; y < height; y++)
+        {
+            if (m_solver.PaddedTile(padded + y) == SolverTile::Mine)
+            {
+                m_knownMines++;
+            }
+        }
+    }
+
+    // Every revealed number with unknown neighbors becomes a constraint on
+    // up to 8 frontier tiles.
+    std::vector<int> constraintTiles;
+    std::vector<int8_t> constraintMines;
+    std::vector<uint8_t> constraintSizes;
+    for (auto x = 0; x < width; x++)
+    {
+        for (auto y = 0; y < height; y++)
+        {
+            auto index = x * height + y;
+            if (mineStates[index] != MineState::Revealed || neighborCounts[index] < 0)
+            {
+                continue;
+            }
+
+            auto padded = layout.ComputeIndex(x, y);
+            int remaining = neighborCounts[index];
+            uint8_t size = 0;
+            int tiles[8];
+            for (auto k = 0; k < 8; k++)
+            {
+                auto tile = m_solver.PaddedTile(padded + paddedOffsets[k]);
+                if (tile == SolverTile::Mine)
+                {
+                    remaining--;
+                }
+                else if (tile == SolverTile::Unknown)
+                {
+                    tiles[size++] = index + offsets[k];
+                }
+            }
+
+            if (remaining < 0 || remaining > size)
+            {
+                return false;
+            }
+            if (size == 0)
+            {
+                continue;
+            }
+
+            for (auto i = 0; i < size; i++)
+            {
+                if (frontierIds[tiles[i]] < 0)
+                {
+                    frontierIds[tiles[i]] = static_cast<int>(frontierTiles.size());
+                    frontierTiles.push_back(tiles[i]);
+                }
+                constraintTiles.push_back(frontierIds[tiles[i]]);
+            }
+            constraintMines.push_back(static_cast<int8_t>(remaining));
+            constraintSizes.push_back(size);
+        }
+    }
+
+    for (auto x = 0; x < width; x++)
+    {
+        auto padded = layout.ComputeIndex(x, 0);
+        for (auto y = 0; y < height; y++)
+        {
+            auto index = x * height + y;
+            if (frontierIds[index] < 0 && m_solver.PaddedTile(padded + y) == SolverTile::Unknown)
+            {
+                m_interiorTiles.push_back(index);
+            }
+        }
+    }
+
+    // Join the tiles of every constraint, and list the constraints of every
+    // frontier tile.
+    auto constraintCount = constraintSizes.size();
+    std::vector<int> constraintStarts(constraintCount + 1, 0);
+    for (size_t c = 0; c < constraintCount; c++)
+    {
+        constraintStarts[c + 1] = constraintStarts[c] + constraintSizes[c];
+    }
+
+    std::vector<int> parents(frontierTiles.size());
+    std::vector<int> tileConstraintStarts(frontierTiles.size() + 1, 0);
+    for (size_t tile = 0; tile < frontierTiles.size(); tile++)
+    {
+        parents[tile] = static_cast<int>(tile);
+    }
+    for (size_t c = 0; c < constraintCount; c++)
+    {
+        auto first = FindRoot(parents, constraintTiles[constraintStarts[c]]);
+        for (auto i = constraintStarts[c]; i < constraintStarts[c + 1]; i++)
+        {
+            tileConstraintStarts[constraintTiles[i] + 1]++;
+            parents[FindRoot(parents, constraintTiles[i])] = first;
+        }
+    }
+    for (size_t tile = 0; tile < frontierTiles.size(); tile++)
+    {
+        tileConstraintStarts[tile + 1] += tileConstraintStarts[tile];
+    }
+    std::vector<int> tileConstraints(tileConstraintStarts.back());
+    {
+        auto next = tileConstraintStarts;
+        for (size_t c = 0; c < constraintCount; c++)
+        {
+            for (auto i = constraintStarts[c]; i < constraintStarts[c + 1]; i++)
+            {
+                tileConstraints[next[constraintTiles[i]]++] = static_cast<int>(c);
+            }
+        }
+    }
+
+    // Order each component breadth first, so that constraints are completed
+    // (and can cut the search) soon after their first tile is assigned.
+    std::vector<int> localTiles(frontierTiles.size(), -1);
+    std::vector<int> localConstraints(constraintCount, -1);
+    for (size_t start = 0; start < frontierTiles.size(); start++)
+    {
+        if (localTiles[start] >= 0)
+        {
+            continue;
+        }
+
+        auto component = std::make_unique<Component>();
+        std::vector<int> order;
+        std::vector<int> constraints;
+        order.push_back(static_cast<int>(start));
+        localTiles[start] = 0;
+        for (size_t next = 0; next < order.size(); next++)
+        {
+            auto tile = order[next];
+            for (auto i = tileConstraintStarts[tile]; i < tileConstraintStarts[tile + 1]; i++)
+            {
+                auto c = tileConstraints[i];
+                if (localConstraints[c] >= 0)
+                {
+                    continue;
+                }
+                localConstraints[c] = static_cast<int>(constraints.size());
+                constraints.push_back(c);
+                for (auto j = constraintStarts[c]; j < constraintStarts[c + 1]; j++)
+                {
+                    auto other = constraintTiles[j];
+                    if (localTiles[other] < 0)
+                    {
+                        localTiles[other] = static_cast<int>(order.size());
+                        order.push_back(other);
+                    }
+                }
+            }
+        }
+
+        for (auto tile : order)
+        {
+            component->tiles.push_back(frontierTiles[tile]);
+            component->tileConstraintStarts.push_back(static_cast<int>(component->constraintIndices.size()));
+            for (auto i = tileConstraintStarts[tile]; i < tileConstraintStarts[tile + 1]; i++)
+            {
+                component->constraintIndices.push_back(localConstraints[tileConstraints[i]]);
+            }
+        }
+        component->tileConstraintStarts.push_back(static_cast<int>(component->constraintIndices.size()));
+        // Every mine is counted once by each constraint its tile is in, so
+        // the constraints' counts add up to somewhere between the fewest and
+        // the most constraints a tile is in for every mine.
+        auto mineSum = 0;
+        for (auto c : constraints)
+        {
+            component->constraintMines.push_back(constraintMines[c]);
+            component->constraintSizes.push_back(constraintSizes[c]);
+            component->minMines = std::max<int>(component->minMines, constraintMines[c]);
+            mineSum += constraintMines[c];
+        }
+        auto fewestConstraints = 8;
+        auto mostConstraints = 1;
+        for (auto tile : order)
+        {
+            auto tileConstraintCount = tileConstraintStarts[tile + 1] - tileConstraintStarts[tile];
+            fewestConstraints = std::min(fewestConstraints, tileConstraintCount);
+            mostConstraints = std::max(mostConstraints, tileConstraintCount);
+        }
+        component->minMines = std::max(component->minMines, (mineSum + mostConstraints - 1) / mostConstraints);
+        component->maxMines = std::min(mineSum / fewestConstraints, static_cast<int>(order.size()));
+        m_components.push_back(std::move(component));
+    }
+
+    return true;
+}
+
+void ProbabilitySolver::Enumerate(ComponentResult& result)
+{
+    auto& component = *result.component;
+    Enumeration enumeration;
+    enumeration.tileCount = static_cast<int>(component.tiles.size());
+    enumeration.minMines = component.minMines;
+    enumeration.maxMines = component.maxMines;
+    enumeration.tileConstraintStarts = component.tileConstraintStarts.data();
+    enumeration.constraintIndices = component.constraintIndices.data();
+    enumeration.constraintMines = component.constraintMines.data();
+    enumeration.prefix = result.prefix;
+    enumeration.prefixLength = result.prefixLength;
+    enumeration.limit = m_enumerationLimit;
+    enumeration.sharedNodes = &component.nodes;
+    enumeration.aborted = &component.aborted;
+    enumeration.mines.assign(component.constraintSizes.size(), 0);
+    enumeration.unassigned.assign(component.constraintSizes.begin(), component.constraintSizes.end());
+    enumeration.weights = &result.weights;
+    enumeration.tileWeights = &result.tileWeights;
+    enumeration.Run();
+}
+
+void ProbabilitySolver::Probe(ComponentResult& result)
+{
+    auto& component = *result.component;
+    auto tileCount = static_cast<int>(component.tiles.size());
+
+    // Knuth's estimate of a search tree: walk from the root to a leaf taking
+    // a random valid branch at every tile, and weigh the leaf by the product
+    // of the number of branches there were to choose from. On average that
+    // is exactly what the full enumeration counts, so there is no burn in
+    // and no mixing to worry about, and every probe costs one pass over the
+    // tiles. A probe that runs into a dead end counts for nothing.
+    std::vector<int> mines(component.constraintSizes.size());
+    std::vector<int> unassigned(component.constraintSizes.size());
+    std::vector<int> mineTiles;
+    auto fits = [&](int tile, int value)
+    {
+        for (auto i = component.tileConstraintStarts[tile]; i < component.tileConstraintStarts[tile + 1]; i++)
+        {
+            auto c = component.constraintIndices[i];
+            if (mines[c] + value > component.constraintMines[c] ||
+                mines[c] + value + unassigned[c] - 1 < component.constraintMines[c])
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto rows = static_cast<size_t>(component.maxMines - component.minMines + 1);
+    result.weights.assign(rows, 0.0);
+    result.tileWeights.assign(rows * tileCount, 0.0);
+    result.exponent = 0;
+    RandomGenerator random(0x5851f42d4c957f2dull + result.seed);
+    auto probes = std::max(1, ProbeSteps / tileCount);
+    for (auto probe = 0; probe < probes; probe++)
+    {
+        std::fill(mines.begin(), mines.end(), 0);
+        std::copy(component.constraintSizes.begin(), component.constraintSizes.end(), unassigned.begin());
+        mineTiles.clear();
+
+        // The weight of a leaf is 2 to the power of the number of tiles
+        // that could have gone either way.
+        auto choices = 0;
+        auto tile = 0;
+        for (; tile < tileCount; tile++)
+        {
+            auto canBeEmpty = fits(tile, 0);
+            auto canBeMine = fits(tile, 1);
+            if (!canBeEmpty && !canBeMine)
+            {
+                break;
+            }
+
+            auto value = canBeMine ? 1 : 0;
+            if (canBeEmpty && canBeMine)
+            {
+                choices++;
+                value = static_cast<int>(random.Next() >> 63);
+            }
+            for (auto i = component.tileConstraintStarts[tile]; i < component.tileConstraintStarts[tile + 1]; i++)
+            {
+                auto c = component.constraintIndices[i];
+                unassigned[c]--;
+                mines[c] += value;
+            }
+            if (value)
+            {
+                mineTiles.push_back(tile);
+            }
+        }
+        if (tile < tileCount)
+        {
+            continue;
+        }
+
+        // Large components can have more leaves than a double can count, so
+        // the sums are kept relative to the heaviest probe so far.
+        if (choices > result.exponent)
+        {
+            auto scale = std::ldexp(1.0, result.exponent - choices);
+            for (auto& value : result.weights)
+            {
+                value *= scale;
+            }
+            for (auto& value : result.tileWeights)
+            {
+                value *= scale;
+            }
+            result.exponent = choices;
+        }
+
+        auto weight = std::ldexp(1.0, choices - result.exponent);
+        auto mineRow = mineTiles.size() - component.minMines;
+        result.weights[mineRow] += weight;
+        auto row = result.tileWeights.data() + mineRow * tileCount;
+        for (auto mineTile : mineTiles)
+        {
+            row[mineTile] += weight;
+        }
+    }
+}
+
+void ProbabilitySolver::MergeResult(ComponentResult const& result)
+{
+    auto& component = *result.component;
+    if (result.weights.empty())
+    {
+        return;
+    }
+
+    if (component.weights.empty())
+    {
+        component.weights.assign(result.weights.size(), 0.0);
+        component.tileWeights.assign(result.tileWeights.size(), 0.0);
+        component.exponent = result.exponent;
+    }
+
+    // Bring both sides to the larger exponent before adding.
+    auto exponent = std::max(component.exponent, result.exponent);
+    auto componentScale = std::ldexp(1.0, component.exponent - exponent);
+    auto resultScale = std::ldexp(1.0, result.exponent - exponent);
+    component.exponent = exponent;
+    for (size_t i = 0; i < result.weights.size(); i++)
+    {
+        component.weights[i] = component.weights[i] * componentScale + result.weights[i] * resultScale;
+    }
+    for (size_t i = 0; i < result.tileWeights.size(); i++)
+    {
+        component.tileWeights[i] = component.tileWeights[i] * componentScale + result.tileWeights[i] * resultScale;
+    }
+}
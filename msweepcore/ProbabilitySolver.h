@@ -0,0 +1,106 @@
+#pragma once
+
+// Computes the chance that each unrevealed tile is a mine, given what the
+// player can see and the total number of mines. MineSolver settles the
+// provable tiles first. The remaining unknowns next to a number (the
+// frontier) are split into components that share no constraints, and every
+// component's valid assignments are enumerated on a WorkStealingPool, counted
+// by how many mines they use. The unknowns that touch no number (the
+// interior) only matter through how many mines they hold, so the components
+// are combined by weighting each total with the number of ways to place the
+// rest of the mines in the interior. A component whose enumeration runs past
+// the node limit, or whose counts wouldn't fit in memory, is estimated from a
+// bounded number of random probes of its search tree instead, which makes its
+// probabilities approximate. One too big to even probe is treated like the
+// interior.
+class ProbabilitySolver
+{
+public:
+    // A threadCount of 0 uses one thread per hardware thread.
+    ProbabilitySolver(int threadCount = 0);
+    ~ProbabilitySolver() {}
+
+    int ThreadCount() const { return m_pool.ThreadCount(); }
+
+    // How many search nodes a single component may use before it is estimated
+    // instead of enumerated.
+    uint64_t EnumerationLimit() const { return m_enumerationLimit; }
+    void SetEnumerationLimit(uint64_t nodes) { m_enumerationLimit = nodes; }
+
+    // Fills probabilities with one value per tile: 0 for revealed tiles, 1
+    // for proven mines (and flags, if trustFlags is true). Returns false if
+    // no placement of numMines mines matches the board, in which case the
+    // probabilities are left unspecified.
+    bool Compute(
+        int width,
+        int height,
+        MineState const* mineStates,
+        int8_t const* neighborCounts,
+        int numMines,
+        bool trustFlags,
+        std::vector<double>& probabilities);
+
+    // Whether the last Compute had to estimate any component.
+    bool UsedEstimate() const { return m_usedEstimate; }
+
+private:
+    struct Component
+    {
+        // Board indices, in the order they are enumerated.
+        std::vector<int> tiles;
+        // For each tile, the constraints it belongs to, as offsets into
+        // constraintIndices.
+        std::vector<int> tileConstraintStarts;
+        std::vector<int> constraintIndices;
+        std::vector<int8_t> constraintMines;
+        std::vector<uint8_t> constraintSizes;
+
+        // Every valid assignment has between minMines and maxMines mines:
+        // at least what the fullest constraint needs and at most what all
+        // of them need together.
+        int minMines = 0;
+        int maxMines = 0;
+        // weights[k - minMines] is the (relative) number of assignments with
+        // k mines, and tileWeights[(k - minMines) * tiles.size() + t] how
+        // many of those have a mine on tile t.
+        std::vector<double> weights;
+        std::vector<double> tileWeights;
+        // Estimated weights are stored divided by 2 to this power.
+        int exponent = 0;
+
+        std::atomic<uint64_t> nodes{ 0 };
+        std::atomic<bool> aborted{ false };
+        bool estimated = false;
+    };
+
+    // The counts from one task. An enumeration task only covers the
+    // assignments that start with the prefixLength tile values in prefix. A
+    // sampling task is a batch of probes seeded with seed.
+    struct ComponentResult
+    {
+        Component* component;
+        uint32_t prefix;
+        int prefixLength;
+        uint64_t seed;
+        std::vector<double> weights;
+        std::vector<double> tileWeights;
+        int exponent;
+    };
+
+    bool BuildComponents(int width, int height, MineState const* mineStates, int8_t const* neighborCounts);
+    void Enumerate(ComponentResult& result);
+    void Probe(ComponentResult& result);
+    static void MergeResult(ComponentResult const& result);
+
+private:
+    WorkStealingPool m_pool;
+    MineSolver m_solver;
+    uint64_t m_enumerationLimit;
+    bool m_usedEstimate = false;
+
+    std::vector<int> m_safeTiles;
+    std::vector<int> m_mineTiles;
+    std::vector<std::unique_ptr<Component>> m_components;
+    std::vector<int> m_interiorTiles;
+    int m_knownMines = 0;
+};
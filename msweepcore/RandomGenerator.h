@@ -0,0 +1,81 @@
+#pragma once
+
+// xoshiro256** seeded through splitmix64. Small, fast, and produces the same
+// sequence on every platform for a given seed, which std::mt19937's
+// distributions don't guarantee.
+struct RandomGenerator
+{
+    uint64_t state[4];
+
+    RandomGenerator(uint64_t seed)
+    {
+        for (auto& word : state)
+        {
+            seed += 0x9e3779b97f4a7c15ull;
+            auto z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static uint64_t RotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t Next()
+    {
+        auto result = RotateLeft(state[1] * 5, 7) * 9;
+        auto shifted = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = RotateLeft(state[3], 45);
+
+        return result;
+    }
+
+    // Advances the state by 2^128 calls to Next. Jumping copies of one
+    // generator 0, 1, 2, ... times gives each thread its own stream that
+    // won't overlap any other's.
+    void Jump()
+    {
+        static const uint64_t JumpPolynomial[] = { 0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+
+        uint64_t jumped[4] = {};
+        for (auto word : JumpPolynomial)
+        {
+            for (auto bit = 0; bit < 64; bit++)
+            {
+                if (word & (1ull << bit))
+                {
+                    for (auto i = 0; i < 4; i++)
+                    {
+                        jumped[i] ^= state[i];
+                    }
+                }
+                Next();
+            }
+        }
+        std::copy(std::begin(jumped), std::end(jumped), state);
+    }
+
+    // Returns a uniformly distributed value in [0, bound).
+    uint64_t NextBelow(uint64_t bound)
+    {
+        // Reject the top partial range so that every value is equally likely.
+        auto threshold = (0 - bound) % bound;
+        while (true)
+        {
+            auto value = Next();
+            if (value >= threshold)
+            {
+                return value % bound;
+            }
+        }
+    }
+};
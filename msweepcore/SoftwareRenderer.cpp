@@ -0,0 +1,229 @@
+#include "pch.h"
+#include "TileArt.h"
+#include "TileUpdates.h"
+#include "SoftwareRenderer.h"
+
+namespace
+{
+    const uint8_t FirstStateLook = 0;
+    const uint8_t MineLook = 3;
+    const uint8_t FirstCountLook = 4;
+
+    // Each pixel's dot coverage is measured on a grid of samples this wide.
+    const int SamplesPerAxis = 4;
+
+    uint32_t ToPixel(TileColor const& color)
+    {
+        return 0xff000000u | (static_cast<uint32_t>(color.r) << 16) | (static_cast<uint32_t>(color.g) << 8) | color.b;
+    }
+
+    uint8_t Blend(uint8_t from, uint8_t to, float amount)
+    {
+        return static_cast<uint8_t>(std::lround(from + (to - from) * amount));
+    }
+}
+
+void TileAtlas::Build(int tileSize)
+{
+    if (tileSize <= 0)
+    {
+        throw std::runtime_error("Tiles need at least one pixel!");
+    }
+
+    m_tileSize = tileSize;
+    m_pixels.assign(static_cast<size_t>(LookCount) * tileSize * tileSize, 0);
+
+    std::vector<TileDot> noDots;
+    for (auto state : { MineState::Empty, MineState::Flag, MineState::Question })
+    {
+        Rasterize(LookFor(state, 0), GetMineStateColor(state), noDots);
+    }
+    Rasterize(MineLook, MineColor, noDots);
+    for (auto count = 0; count <= 8; count++)
+    {
+        Rasterize(static_cast<uint8_t>(FirstCountLook + count), GetMineCountColor(count), GetMineCountDots(count));
+    }
+}
+
+uint8_t TileAtlas::LookFor(MineState state, int8_t count)
+{
+    if (state != MineState::Revealed)
+    {
+        return static_cast<uint8_t>(FirstStateLook + static_cast<uint8_t>(state));
+    }
+    if (count < 0)
+    {
+        return MineLook;
+    }
+    return static_cast<uint8_t>(FirstCountLook + count);
+}
+
+void TileAtlas::Rasterize(uint8_t look, TileColor const& background, std::vector<TileDot> const& dots)
+{
+    auto pixels = m_pixels.data() + static_cast<size_t>(look) * m_tileSize * m_tileSize;
+    auto size = static_cast<float>(m_tileSize);
+    auto radius = size * TileDotRadius;
+    for (auto y = 0; y < m_tileSize; y++)
+    {
+        for (auto x = 0; x < m_tileSize; x++)
+        {
+            // The dots never overlap, so the coverage can just be summed.
+            auto covered = 0;
+            for (auto sampleY = 0; sampleY < SamplesPerAxis; sampleY++)
+            {
+                for (auto sampleX = 0; sampleX < SamplesPerAxis; sampleX++)
+                {
+                    auto pointX = x + (sampleX + 0.5f) / SamplesPerAxis;
+                    auto pointY = y + (sampleY + 0.5f) / SamplesPerAxis;
+                    for (auto& dot : dots)
+                    {
+                        auto dx = pointX - dot.x * size;
+                        auto dy = pointY - dot.y * size;
+                        if (dx * dx + dy * dy <= radius * radius)
+                        {
+                            covered++;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            auto amount = static_cast<float>(covered) / (SamplesPerAxis * SamplesPerAxis);
+            TileColor color =
+            {
+                Blend(background.r, DotColor.r, amount),
+                Blend(background.g, DotColor.g, amount),
+                Blend(background.b, DotColor.b, amount),
+            };
+            pixels[y * m_tileSize + x] = ToPixel(color);
+        }
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer(int tileSize, int margin)
+{
+    if (margin < 0)
+    {
+        throw std::runtime_error("The margin can't be negative!");
+    }
+
+    m_atlas.Build(tileSize);
+    m_margin = margin;
+}
+
+void SoftwareRenderer::Reset(int boardWidth, int boardHeight)
+{
+    auto pitch = static_cast<int64_t>(m_atlas.TileSize()) + m_margin;
+    auto frameWidth = pitch * boardWidth;
+    auto frameHeight = pitch * boardHeight;
+    if (boardWidth <= 0 || boardHeight <= 0 || frameWidth * frameHeight > std::numeric_limits<int32_t>::max())
+    {
+        throw std::runtime_error("The frame for this board is too big to render!");
+    }
+
+    m_boardWidth = boardWidth;
+    m_boardHeight = boardHeight;
+    m_frameWidth = static_cast<int>(frameWidth);
+    m_frameHeight = static_cast<int>(frameHeight);
+    m_pixels.assign(static_cast<size_t>(frameWidth * frameHeight), ToPixel(BoardBackgroundColor));
+
+    auto tileCount = static_cast<size_t>(boardWidth) * boardHeight;
+    m_looks.assign(tileCount, TileAtlas::LookFor(MineState::Empty, 0));
+    m_isDirty.assign(tileCount, 0);
+    m_dirtyTiles.clear();
+    m_redrawAll = true;
+}
+
+void SoftwareRenderer::SetBoard(MineState const* mineStates, int8_t const* neighborCounts)
+{
+    for (auto index = 0; index < m_boardWidth * m_boardHeight; index++)
+    {
+        SetLook(index, TileAtlas::LookFor(mineStates[index], neighborCounts[index]));
+    }
+}
+
+void SoftwareRenderer::ApplyTileUpdates(TileUpdate const* updates, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        SetLook(updates[i].index, TileAtlas::LookFor(updates[i].state, updates[i].count));
+    }
+}
+
+size_t SoftwareRenderer::Render()
+{
+    size_t drawn = 0;
+    if (m_redrawAll)
+    {
+        for (auto index = 0; index < m_boardWidth * m_boardHeight; index++)
+        {
+            DrawTile(index);
+        }
+        drawn = m_looks.size();
+        m_redrawAll = false;
+    }
+    else
+    {
+        for (auto index : m_dirtyTiles)
+        {
+            DrawTile(index);
+        }
+        drawn = m_dirtyTiles.size();
+    }
+
+    for (auto index : m_dirtyTiles)
+    {
+        m_isDirty[index] = 0;
+    }
+    m_dirtyTiles.clear();
+    return drawn;
+}
+
+void SoftwareRenderer::WritePpm(std::vector<uint8_t>& output) const
+{
+    char header[64];
+    auto headerSize = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", m_frameWidth, m_frameHeight);
+    output.resize(headerSize + m_pixels.size() * 3);
+    std::memcpy(output.data(), header, headerSize);
+
+    auto rgb = output.data() + headerSize;
+    for (auto pixel : m_pixels)
+    {
+        *rgb++ = static_cast<uint8_t>(pixel >> 16);
+        *rgb++ = static_cast<uint8_t>(pixel >> 8);
+        *rgb++ = static_cast<uint8_t>(pixel);
+    }
+}
+
+void SoftwareRenderer::SetLook(int index, uint8_t look)
+{
+    if (m_looks[index] == look)
+    {
+        return;
+    }
+
+    m_looks[index] = look;
+    if (!m_isDirty[index] && !m_redrawAll)
+    {
+        m_isDirty[index] = 1;
+        m_dirtyTiles.push_back(index);
+    }
+}
+
+void SoftwareRenderer::DrawTile(int index)
+{
+    // Each row of a tile is contiguous in both the atlas and the frame, so a
+    // tile is TileSize() copies that the compiler turns into vector moves.
+    auto tileSize = m_atlas.TileSize();
+    auto pitch = tileSize + m_margin;
+    auto x = index / m_boardHeight;
+    auto y = index % m_boardHeight;
+    auto source = m_atlas.GetLook(m_looks[index]);
+    auto destination = m_pixels.data() + static_cast<size_t>(m_margin / 2 + y * pitch) * m_frameWidth + (m_margin / 2 + x * pitch);
+    for (auto row = 0; row < tileSize; row++)
+    {
+        std::memcpy(destination, source, tileSize * sizeof(uint32_t));
+        source += tileSize;
+        destination += m_frameWidth;
+    }
+}
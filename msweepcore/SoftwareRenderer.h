@@ -0,0 +1,77 @@
+#pragma once
+
+// Every look a tile can have, rasterized once for one tile size. Pixels are
+// 0xAARRGGBB and each look is TileSize() rows of TileSize() pixels.
+class TileAtlas
+{
+public:
+    // Empty, Flag and Question come first, then a mine, then the counts 0 to 8.
+    static const int LookCount = 13;
+
+    TileAtlas() {}
+    ~TileAtlas() {}
+
+    void Build(int tileSize);
+    int TileSize() const { return m_tileSize; }
+    uint32_t const* GetLook(uint8_t look) const { return m_pixels.data() + static_cast<size_t>(look) * m_tileSize * m_tileSize; }
+
+    // count only matters for a revealed tile: -1 for a mine, otherwise the
+    // number of surrounding mines.
+    static uint8_t LookFor(MineState state, int8_t count);
+
+private:
+    void Rasterize(uint8_t look, TileColor const& background, std::vector<TileDot> const& dots);
+
+private:
+    int m_tileSize = 0;
+    std::vector<uint32_t> m_pixels;
+};
+
+// Draws a board into a framebuffer on the CPU, laid out the same as
+// VisualGrid: square tiles with margin pixels between them. Tiles are copied
+// row by row out of a TileAtlas, and only the tiles whose look changed since
+// the last Render are drawn again. As a TileUpdateSink it can be handed
+// straight to a MinesweeperGame, so a game can be drawn without Windows.
+class SoftwareRenderer : public TileUpdateSink
+{
+public:
+    SoftwareRenderer(int tileSize, int margin);
+    ~SoftwareRenderer() override {}
+
+    // Starts a new board with every tile Empty. The next Render draws the
+    // whole frame.
+    void Reset(int boardWidth, int boardHeight);
+    // Takes the look of every tile from a board in IndexHelper order.
+    void SetBoard(MineState const* mineStates, int8_t const* neighborCounts);
+    void ApplyTileUpdates(TileUpdate const* updates, size_t count) override;
+
+    // Draws everything that changed and returns how many tiles were drawn.
+    size_t Render();
+
+    int FrameWidth() const { return m_frameWidth; }
+    int FrameHeight() const { return m_frameHeight; }
+    uint32_t const* Pixels() const { return m_pixels.data(); }
+    TileAtlas const& Atlas() const { return m_atlas; }
+
+    // Writes the frame as a binary PPM (P6) into output, reusing its capacity.
+    void WritePpm(std::vector<uint8_t>& output) const;
+
+private:
+    void SetLook(int index, uint8_t look);
+    void DrawTile(int index);
+
+private:
+    TileAtlas m_atlas;
+    int m_margin = 0;
+
+    int m_boardWidth = 0;
+    int m_boardHeight = 0;
+    int m_frameWidth = 0;
+    int m_frameHeight = 0;
+    std::vector<uint32_t> m_pixels;
+
+    std::vector<uint8_t> m_looks;
+    std::vector<uint8_t> m_isDirty;
+    std::vector<int> m_dirtyTiles;
+    bool m_redrawAll = false;
+};
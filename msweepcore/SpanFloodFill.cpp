@@ -0,0 +1,156 @@
+#include "pch.h"
+#include "SpanFloodFill.h"
+
+namespace
+{
+    inline bool IsUnmarkedZero(MineState const* column, int8_t const* counts, int y)
+    {
+        return column[y] == MineState::Empty && counts[y] == 0;
+    }
+}
+
+void SpanFloodFill::Fill(
+    MineState* mineStates,
+    int8_t const* neighborCounts,
+    int width,
+    int height,
+    int x,
+    int y,
+    std::vector<TileSpan>& revealedSpans)
+{
+    m_seeds.clear();
+    m_seeds.push_back({ x, y });
+
+    // The whole board is a single stripe, nothing can spill out of it.
+    m_unusedRanges.clear();
+    FloodSeeds(mineStates, neighborCounts, width, height, 0, width - 1, revealedSpans, m_unusedRanges);
+}
+
+void SpanFloodFill::FillStripe(
+    MineState* mineStates,
+    int8_t const* neighborCounts,
+    int width,
+    int height,
+    int firstColumn,
+    int lastColumn,
+    std::vector<ColumnRange> const& ranges,
+    std::vector<TileSpan>& revealedSpans,
+    std::vector<ColumnRange>& outgoingRanges)
+{
+    m_seeds.clear();
+    for (auto& range : ranges)
+    {
+        ScanNeighborColumn(mineStates, neighborCounts, height, range.x, range.firstY, range.lastY, revealedSpans);
+    }
+
+    FloodSeeds(mineStates, neighborCounts, width, height, firstColumn, lastColumn, revealedSpans, outgoingRanges);
+}
+
+void SpanFloodFill::FloodSeeds(
+    MineState* mineStates,
+    int8_t const* neighborCounts,
+    int width,
+    int height,
+    int firstColumn,
+    int lastColumn,
+    std::vector<TileSpan>& revealedSpans,
+    std::vector<ColumnRange>& outgoingRanges)
+{
+    while (!m_seeds.empty())
+    {
+        auto seed = m_seeds.back();
+        m_seeds.pop_back();
+
+        auto column = mineStates + static_cast<size_t>(seed.x) * height;
+        auto counts = neighborCounts + static_cast<size_t>(seed.x) * height;
+
+        // Another span may have already covered this seed.
+        if (column[seed.y] != MineState::Empty)
+        {
+            continue;
+        }
+
+        // Extend the run of zero tiles in both directions.
+        auto firstZero = seed.y;
+        while (firstZero > 0 && IsUnmarkedZero(column, counts, firstZero - 1))
+        {
+            firstZero--;
+        }
+        auto lastZero = seed.y;
+        while (lastZero < height - 1 && IsUnmarkedZero(column, counts, lastZero + 1))
+        {
+            lastZero++;
+        }
+
+        // The unmarked tiles just past either end of the run are its numbered border.
+        auto first = firstZero;
+        if (first > 0 && column[first - 1] == MineState::Empty)
+        {
+            first--;
+        }
+        auto last = lastZero;
+        if (last < height - 1 && column[last + 1] == MineState::Empty)
+        {
+            last++;
+        }
+
+        std::fill(column + first, column + last + 1, MineState::Revealed);
+        revealedSpans.push_back({ seed.x, first, last - first + 1 });
+
+        // Every tile in the neighboring columns next to the run touches a zero tile.
+        auto neighborFirst = std::max(0, firstZero - 1);
+        auto neighborLast = std::min(height - 1, lastZero + 1);
+        for (auto neighborX : { seed.x - 1, seed.x + 1 })
+        {
+            if (neighborX >= firstColumn && neighborX <= lastColumn)
+            {
+                ScanNeighborColumn(mineStates, neighborCounts, height, neighborX, neighborFirst, neighborLast, revealedSpans);
+            }
+            else if (neighborX >= 0 && neighborX < width)
+            {
+                outgoingRanges.push_back({ neighborX, neighborFirst, neighborLast });
+            }
+        }
+    }
+}
+
+void SpanFloodFill::ScanNeighborColumn(
+    MineState* mineStates,
+    int8_t const* neighborCounts,
+    int height,
+    int x,
+    int firstY,
+    int lastY,
+    std::vector<TileSpan>& revealedSpans)
+{
+    auto column = mineStates + static_cast<size_t>(x) * height;
+    auto counts = neighborCounts + static_cast<size_t>(x) * height;
+
+    auto y = firstY;
+    while (y <= lastY)
+    {
+        if (column[y] != MineState::Empty)
+        {
+            y++;
+        }
+        else if (counts[y] == 0)
+        {
+            // Seed the run once, it will be extended when it is popped.
+            m_seeds.push_back({ x, y });
+            while (y <= lastY && IsUnmarkedZero(column, counts, y))
+            {
+                y++;
+            }
+        }
+        else
+        {
+            auto start = y;
+            while (y <= lastY && column[y] == MineState::Empty && counts[y] != 0)
+            {
+                column[y] = MineState::Revealed;
+                y++;
+            }
+            revealedSpans.push_back({ x, start, y - start });
+        }
+    }
+}
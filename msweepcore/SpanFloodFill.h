@@ -0,0 +1,85 @@
+#pragma once
+
+// A run of tiles in a single column, the board's contiguous axis.
+struct TileSpan
+{
+    int x;
+    int y;
+    int length;
+};
+
+// A range of tiles in a single column whose neighborhood still needs to be
+// scanned. Used to hand work across stripe borders.
+struct ColumnRange
+{
+    int x;
+    int firstY;
+    int lastY;
+};
+
+// Reveals the opening around an empty tile one column run at a time. Whole
+// runs of zero tiles are filled along y, and the numbered tiles bordering them
+// are revealed in the same pass. The seed stack is kept between fills so that
+// repeated sweeps don't reallocate.
+class SpanFloodFill
+{
+public:
+    SpanFloodFill() {}
+    ~SpanFloodFill() {}
+
+    // Marks every tile uncovered by sweeping (x, y) as revealed and appends
+    // them to revealedSpans. (x, y) must be an unmarked tile with no
+    // surrounding mines.
+    void Fill(
+        MineState* mineStates,
+        int8_t const* neighborCounts,
+        int width,
+        int height,
+        int x,
+        int y,
+        std::vector<TileSpan>& revealedSpans);
+
+    // Scans the given column ranges and floods from them, but only touches
+    // columns in [firstColumn, lastColumn]. Neighborhoods that spill into
+    // other columns are appended to outgoingRanges instead, so that several
+    // fills can work on disjoint stripes of the same board at once.
+    void FillStripe(
+        MineState* mineStates,
+        int8_t const* neighborCounts,
+        int width,
+        int height,
+        int firstColumn,
+        int lastColumn,
+        std::vector<ColumnRange> const& ranges,
+        std::vector<TileSpan>& revealedSpans,
+        std::vector<ColumnRange>& outgoingRanges);
+
+private:
+    struct Seed
+    {
+        int x;
+        int y;
+    };
+
+    void FloodSeeds(
+        MineState* mineStates,
+        int8_t const* neighborCounts,
+        int width,
+        int height,
+        int firstColumn,
+        int lastColumn,
+        std::vector<TileSpan>& revealedSpans,
+        std::vector<ColumnRange>& outgoingRanges);
+    void ScanNeighborColumn(
+        MineState* mineStates,
+        int8_t const* neighborCounts,
+        int height,
+        int x,
+        int firstY,
+        int lastY,
+        std::vector<TileSpan>& revealedSpans);
+
+private:
+    std::vector<Seed> m_seeds;
+    std::vector<ColumnRange> m_unusedRanges;
+};
@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "TileArt.h"
+
+TileColor GetMineStateColor(MineState state)
+{
+    switch (state)
+    {
+    case MineState::Empty:
+        return { 0, 0, 255 }; // Blue
+    case MineState::Flag:
+        return { 255, 165, 0 }; // Orange
+    case MineState::Question:
+        return { 50, 205, 50 }; // LimeGreen
+    case MineState::Revealed:
+        throw std::runtime_error("Revealed tiles are colored by their mine count!");
+    }
+    throw std::runtime_error("Unknown mine state!");
+}
+
+TileColor GetMineCountColor(int count)
+{
+    static const TileColor colors[] =
+    {
+        { 245, 245, 245 }, // WhiteSmoke
+        { 173, 216, 230 }, // LightBlue
+        { 144, 238, 144 }, // LightGreen
+        { 255, 160, 122 }, // LightSalmon
+        { 176, 196, 222 }, // LightSteelBlue
+        { 147, 112, 219 }, // MediumPurple
+        { 224, 255, 255 }, // LightCyan
+        { 128, 0, 0 }, // Maroon
+        { 143, 188, 143 }, // DarkSeaGreen
+    };
+    return colors[count];
+}
+
+std::vector<TileDot> const& GetMineCountDots(int count)
+{
+    static const float third = 1.0f / 3.0f;
+    static const std::vector<TileDot> dots[] =
+    {
+        // 0
+        {},
+        // 1
+        { { 0.5f, 0.5f } },
+        // 2
+        { { third, 0.5f }, { third * 2.0f, 0.5f } },
+        // 3
+        { { 0.5f, 0.5f }, { 0.25f, 0.75f }, { 0.75f, 0.25f } },
+        // 4
+        { { third, third }, { third * 2.0f, third }, { third, third * 2.0f }, { third * 2.0f, third * 2.0f } },
+        // 5
+        { { 0.5f, 0.5f }, { 0.25f, 0.75f }, { 0.75f, 0.25f }, { 0.25f, 0.25f }, { 0.75f, 0.75f } },
+        // 6
+        { { 0.25f, 0.5f }, { 0.25f, 0.75f }, { 0.75f, 0.25f }, { 0.25f, 0.25f }, { 0.75f, 0.75f }, { 0.75f, 0.5f } },
+        // 7
+        { { 0.25f, 0.5f }, { 0.25f, 0.75f }, { 0.75f, 0.25f }, { 0.25f, 0.25f }, { 0.75f, 0.75f }, { 0.75f, 0.5f }, { 0.5f, 0.5f } },
+        // 8
+        { { 0.25f, 0.5f }, { 0.25f, 0.75f }, { 0.75f, 0.25f }, { 0.25f, 0.25f }, { 0.75f, 0.75f }, { 0.75f, 0.5f }, { 0.5f, third }, { 0.5f, third * 2.0f } },
+    };
+    return dots[count];
+}
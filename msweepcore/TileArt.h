@@ -0,0 +1,32 @@
+#pragma once
+
+// What every tile looks like, kept free of any graphics API so that CompAssets
+// and the software renderer draw the same board.
+struct TileColor
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+};
+
+// A dot's center as a fraction of the tile's width and height.
+struct TileDot
+{
+    float x;
+    float y;
+};
+
+// Dots are circles with a radius of this fraction of the tile size.
+const float TileDotRadius = 1.0f / 12.0f;
+
+// The background of the whole window, between and around the tiles.
+const TileColor BoardBackgroundColor = { 255, 255, 255 }; // White
+const TileColor MineColor = { 255, 0, 0 }; // Red
+const TileColor DotColor = { 0, 0, 0 }; // Black
+
+// The color of a tile that hasn't been revealed. state must not be Revealed.
+TileColor GetMineStateColor(MineState state);
+// The background of a revealed tile with count (0 to 8) surrounding mines.
+TileColor GetMineCountColor(int count);
+// The dots drawn on a revealed tile with count (0 to 8) surrounding mines.
+std::vector<TileDot> const& GetMineCountDots(int count);
@@ -0,0 +1,145 @@
+#include "pch.h"
+#include "MineBitBoard.h"
+#include "TilePacking.h"
+
+namespace
+{
+    // The scalar paths, also used for whatever is left over after the last
+    // whole register. start must be a multiple of 8.
+    void PackTileStatesScalar(MineState const* mineStates, size_t start, size_t tileCount, uint8_t* packed)
+    {
+        for (auto i = start; i < tileCount; i += 4)
+        {
+            uint8_t value = 0;
+            for (size_t j = 0; j < 4 && i + j < tileCount; j++)
+            {
+                value |= static_cast<uint8_t>(static_cast<uint8_t>(mineStates[i + j]) << (j * 2));
+            }
+            packed[i / 4] = value;
+        }
+    }
+
+    void UnpackTileStatesScalar(uint8_t const* packed, size_t start, size_t tileCount, MineState* mineStates)
+    {
+        for (auto i = start; i < tileCount; i++)
+        {
+            mineStates[i] = static_cast<MineState>((packed[i / 4] >> ((i % 4) * 2)) & 0x3);
+        }
+    }
+
+    void PackMinesScalar(int8_t const* neighborCounts, size_t start, size_t tileCount, uint8_t* bits)
+    {
+        for (auto i = start; i < tileCount; i += 8)
+        {
+            uint8_t value = 0;
+            for (size_t j = 0; j < 8 && i + j < tileCount; j++)
+            {
+                // -1 means a mine
+                value |= static_cast<uint8_t>((neighborCounts[i + j] < 0 ? 1 : 0) << j);
+            }
+            bits[i / 8] = value;
+        }
+    }
+
+#if MSWEEP_AVX2_AVAILABLE
+    // Returns how many tiles were packed, a multiple of 32.
+    MSWEEP_AVX2_TARGET size_t PackTileStatesAvx2(MineState const* mineStates, size_t tileCount, uint8_t* packed)
+    {
+        // Pairs of tiles are joined into 16 bit lanes (a + b * 4), those into
+        // 32 bit lanes (ab + cd * 16), and the low byte of every 32 bit lane
+        // is then gathered into the bottom 8 bytes.
+        auto pairWeights = _mm256_set1_epi16(0x0401);
+        auto quadWeights = _mm256_set1_epi32(0x00100001);
+        auto lowBytes = _mm256_setr_epi8(
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        auto bothLanes = _mm256_setr_epi32(0, 4, 1, 2, 3, 5, 6, 7);
+
+        size_t i = 0;
+        for (; i + 32 <= tileCount; i += 32)
+        {
+            auto states = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(mineStates + i));
+            auto pairs = _mm256_maddubs_epi16(states, pairWeights);
+            auto quads = _mm256_madd_epi16(pairs, quadWeights);
+            auto gathered = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(quads, lowBytes), bothLanes);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(packed + i / 4), _mm256_castsi256_si128(gathered));
+        }
+        return i;
+    }
+
+    MSWEEP_AVX2_TARGET size_t UnpackTileStatesAvx2(uint8_t const* packed, size_t tileCount, MineState* mineStates)
+    {
+        // Every packed byte is copied to the four tiles it holds, and each
+        // tile then tests its own two bits.
+        auto spread = _mm256_setr_epi8(
+            0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+            4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+        auto lowBits = _mm256_set1_epi32(0x40100401);
+        auto highBits = _mm256_set1_epi32(static_cast<int>(0x80200802));
+        auto one = _mm256_set1_epi8(1);
+        auto two = _mm256_set1_epi8(2);
+
+        size_t i = 0;
+        for (; i + 32 <= tileCount; i += 32)
+        {
+            int64_t word;
+            memcpy(&word, packed + i / 4, sizeof(word));
+            auto bytes = _mm256_shuffle_epi8(_mm256_set1_epi64x(word), spread);
+            auto low = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, lowBits), lowBits);
+            auto high = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, highBits), highBits);
+            auto states = _mm256_or_si256(_mm256_and_si256(low, one), _mm256_and_si256(high, two));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(mineStates + i), states);
+        }
+        return i;
+    }
+
+    MSWEEP_AVX2_TARGET size_t PackMinesAvx2(int8_t const* neighborCounts, size_t tileCount, uint8_t* bits)
+    {
+        // A mine's count is -1, the only count with its sign bit set.
+        size_t i = 0;
+        for (; i + 32 <= tileCount; i += 32)
+        {
+            auto counts = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(neighborCounts + i));
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(counts));
+            memcpy(bits + i / 8, &mask, sizeof(mask));
+        }
+        return i;
+    }
+#endif
+}
+
+void PackTileStates(MineState const* mineStates, size_t tileCount, uint8_t* packed)
+{
+    size_t done = 0;
+#if MSWEEP_AVX2_AVAILABLE
+    if (IsAvx2Supported())
+    {
+        done = PackTileStatesAvx2(mineStates, tileCount, packed);
+    }
+#endif
+    PackTileStatesScalar(mineStates, done, tileCount, packed);
+}
+
+void UnpackTileStates(uint8_t const* packed, size_t tileCount, MineState* mineStates)
+{
+    size_t done = 0;
+#if MSWEEP_AVX2_AVAILABLE
+    if (IsAvx2Supported())
+    {
+        done = UnpackTileStatesAvx2(packed, tileCount, mineStates);
+    }
+#endif
+    UnpackTileStatesScalar(packed, done, tileCount, mineStates);
+}
+
+void PackMines(int8_t const* neighborCounts, size_t tileCount, uint8_t* bits)
+{
+    size_t done = 0;
+#if MSWEEP_AVX2_AVAILABLE
+    if (IsAvx2Supported())
+    {
+        done = PackMinesAvx2(neighborCounts, tileCount, bits);
+    }
+#endif
+    PackMinesScalar(neighborCounts, done, tileCount, bits);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Bulk conversions between the board's byte per tile arrays and the packed
+// forms snapshots store: tile states two bits per tile, four to a byte, and
+// mines one bit per tile, eight to a byte. Both are in IndexHelper order with
+// the first tile in the lowest bits. With AVX2 each register converts 32
+// tiles, the rest go a tile at a time.
+
+// Writes every byte of packed, which holds (tileCount + 3) / 4 bytes.
+void PackTileStates(MineState const* mineStates, size_t tileCount, uint8_t* packed);
+void UnpackTileStates(uint8_t const* packed, size_t tileCount, MineState* mineStates);
+
+// Sets the bit of every tile whose neighbor count is -1 and clears the rest.
+// Writes every byte of bits, which holds (tileCount + 7) / 8 bytes.
+void PackMines(int8_t const* neighborCounts, size_t tileCount, uint8_t* bits);
@@ -0,0 +1,14 @@
+#include "pch.h"
+#include "TileUpdates.h"
+
+void TileUpdateRecorder::ApplyTileUpdates(TileUpdate const* updates, size_t count)
+{
+    m_updates.insert(m_updates.end(), updates, updates + count);
+    m_batchEnds.push_back(m_updates.size());
+}
+
+void TileUpdateRecorder::Clear()
+{
+    m_updates.clear();
+    m_batchEnds.clear();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// One tile's new look after an input. count only means something for a
+// revealed tile: -1 for a mine, otherwise how many mines surround it.
+struct TileUpdate
+{
+    int32_t index;
+    MineState state;
+    int8_t count;
+};
+
+// Receives every tile change one input makes as a single batch, in
+// IndexHelper order within each revealed run. This is the only call the game
+// makes into whatever draws it per input, so the game crosses into the UI
+// once per input however many tiles change. What each tile in the batch
+// costs after that is up to the sink.
+class TileUpdateSink
+{
+public:
+    virtual ~TileUpdateSink() {}
+
+    virtual void ApplyTileUpdates(TileUpdate const* updates, size_t count) = 0;
+};
+
+// Keeps every batch it's given, so a game can be played headless and its
+// output checked or timed without a UI.
+class TileUpdateRecorder : public TileUpdateSink
+{
+public:
+    TileUpdateRecorder() {}
+    ~TileUpdateRecorder() override {}
+
+    void ApplyTileUpdates(TileUpdate const* updates, size_t count) override;
+    void Clear();
+
+    // Every update received so far, batches back to back.
+    std::vector<TileUpdate> const& Updates() const { return m_updates; }
+    // Where each batch ends in Updates().
+    std::vector<size_t> const& BatchEnds() const { return m_batchEnds; }
+
+private:
+    std::vector<TileUpdate> m_updates;
+    std::vector<size_t> m_batchEnds;
+};
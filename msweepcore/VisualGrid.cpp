@@ -43,6 +43,8 @@ void VisualGrid::Reset(
 
     m_root.Children().RemoveAll();
     m_tiles.clear();
+    // The selected tile's visual is gone.
+    SelectTile(std::nullopt);
 
     m_root.Size((m_tileSize + m_margin) * float2(m_gridWidthInTiles, m_gridHeightInTiles));
     m_indexHelper = std::make_unique<IndexHelper>(m_gridWidthInTiles, m_gridHeightInTiles);
@@ -84,6 +86,13 @@ SpriteVisual VisualGrid::GetTile(int x, int y)
 
 void VisualGrid::SelectTile(std::optional<TileCoordinate> tileCoordinate)
 {
+    // Moving the selection reparents it, so don't when the tile is the same.
+    if (tileCoordinate.has_value() == m_currentSelection.has_value() &&
+        (!tileCoordinate || (tileCoordinate->x == m_currentSelection->x && tileCoordinate->y == m_currentSelection->y)))
+    {
+        return;
+    }
+
     m_currentSelection = tileCoordinate;
     if (auto selectedTileCoordinate = tileCoordinate)
     {
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (auto i = 0; i < threadCount; i++)
+    {
+        m_queues.push_back(std::make_unique<TaskQueue>());
+    }
+    // The first queue belongs to whichever thread calls Run.
+    for (size_t i = 1; i < m_queues.size(); i++)
+    {
+        m_threads.emplace_back(&WorkStealingPool::RunWorker, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::Run(std::vector<std::function<void()>>& tasks)
+{
+    if (tasks.empty())
+    {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_exception = nullptr;
+        m_unfinishedTasks = tasks.size();
+
+        // Deal the tasks out like cards. Nobody is running yet, so the queue
+        // locks are only taken to keep the accesses ordered.
+        for (size_t i = 0; i < tasks.size(); i++)
+        {
+            auto& queue = *m_queues[i % m_queues.size()];
+            std::unique_lock<std::mutex> queueLock(queue.lock);
+            queue.tasks.push_back(std::move(tasks[i]));
+        }
+        m_queuedTasks = tasks.size();
+    }
+    tasks.clear();
+    m_wake.notify_all();
+
+    while (TryRunTask(0))
+    {
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_finished.wait(lock, [&]() { return m_unfinishedTasks == 0; });
+    if (m_exception)
+    {
+        auto exception = m_exception;
+        m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+void WorkStealingPool::RunWorker(size_t queueIndex)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_wake.wait(lock, [&]() { return m_stopping || m_queuedTasks > 0; });
+            if (m_stopping)
+            {
+                return;
+            }
+        }
+
+        while (TryRunTask(queueIndex))
+        {
+        }
+    }
+}
+
+bool WorkStealingPool::TryRunTask(size_t queueIndex)
+{
+    std::function<void()> task;
+
+    // Our own newest task first, then the oldest task of everyone else.
+    {
+        auto& queue = *m_queues[queueIndex];
+        std::unique_lock<std::mutex> queueLock(queue.lock);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+    for (size_t i = 1; !task && i < m_queues.size(); i++)
+    {
+        auto& queue = *m_queues[(queueIndex + i) % m_queues.size()];
+        std::unique_lock<std::mutex> queueLock(queue.lock);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+    {
+        return false;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_queuedTasks--;
+    }
+
+    std::exception_ptr exception;
+    try
+    {
+        task();
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (exception && !m_exception)
+    {
+        m_exception = exception;
+    }
+    if (--m_unfinishedTasks == 0)
+    {
+        m_finished.notify_all();
+    }
+    return true;
+}
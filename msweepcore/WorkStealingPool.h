@@ -0,0 +1,44 @@
+#pragma once
+
+// A fixed set of worker threads that each own a deque of tasks. Run spreads
+// a batch of tasks across the deques; a worker takes from the back of its own
+// deque and, once that's empty, steals from the front of the others. Uneven
+// tasks (like enumerating constraint components of very different sizes)
+// therefore balance out without any up front scheduling. The threads sleep
+// between batches, so one pool can be kept around and reused.
+class WorkStealingPool
+{
+public:
+    // A threadCount of 0 uses one thread per hardware thread. The thread
+    // calling Run counts as one of them.
+    WorkStealingPool(int threadCount = 0);
+    ~WorkStealingPool();
+
+    int ThreadCount() const { return static_cast<int>(m_queues.size()); }
+
+    // Runs every task and returns once they have all finished. If a task
+    // throws, the first exception is rethrown here after the rest finish.
+    void Run(std::vector<std::function<void()>>& tasks);
+
+private:
+    struct TaskQueue
+    {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void RunWorker(size_t queueIndex);
+    bool TryRunTask(size_t queueIndex);
+
+private:
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+    size_t m_queuedTasks = 0;
+    size_t m_unfinishedTasks = 0;
+    bool m_stopping = false;
+    std::exception_ptr m_exception;
+};
@@ -1,5 +1,5 @@
 #pragma once
-enum class MineState
+enum class MineState : uint8_t
 {
     Empty = 0,
     Flag = 1,
@@ -7,24 +7,85 @@ enum class MineState
     Revealed = 3
 };
 
-enum class MineGenerationState
+enum class MineGenerationState : uint8_t
 {
     Deferred,
     Generated,
 };
 
+enum class GameOutcome : uint8_t
+{
+    Playing = 0,
+    Won = 1,
+    Lost = 2,
+};
+
+// The composition UI, Windows only. Everything above is shared with the
+// headless code.
+#ifdef _WIN32
 class IMinesweeper
 {
 public:
     virtual ~IMinesweeper() {}
 
+    // Pointer input is only queued here. Moves in between two calls to
+    // ProcessInput collapse into the latest one.
     virtual void OnPointerMoved(winrt::Windows::Foundation::Numerics::float2 point) = 0;
     virtual void OnParentSizeChanged(winrt::Windows::Foundation::Numerics::float2 newSize) = 0;
     virtual void OnPointerPressed(
         bool isRightButton,
         bool isEraser) = 0;
+    // Handles the queued pointer input in order. Hosts call this once per
+    // frame, after the input that arrived during it.
+    virtual void ProcessInput() = 0;
+    // Draws the next frame of the game over animation, pointer input is
+    // ignored until it ends. Returns true while there are frames left, hosts
+    // call this once per frame after ProcessInput until it returns false.
+    virtual bool Animate() = 0;
+
+    // Starts a new game. Passing the seed of a previous game (and clicking the
+    // same first tile) reproduces its mine layout exactly.
+    virtual void NewGame(int boardWidth, int boardHeight, int mines, std::optional<uint64_t> seed = std::nullopt) = 0;
+    virtual uint64_t Seed() = 0;
+
+    // Makes the first sweep of every game look for a layout that can be
+    // solved without guessing. Seed() returns the seed that was found.
+    virtual void SetNoGuess(bool noGuess) = 0;
+
+    // Steps back or forward through the presses of the current game, after
+    // handling any input queued before it. Returns false if there is nothing
+    // to undo or redo. A game that was stepped through can't be logged.
+    virtual bool Undo() = 0;
+    virtual bool Redo() = 0;
+
+    // Backs the board with a memory mapped file so that it persists as it's
+    // played. A file that already holds a board is picked back up, otherwise
+    // a new game is started in it. Undo, Redo and autosave are off until
+    // the file is closed, since they would copy the whole board to memory.
+    virtual void OpenBoardFile(std::wstring const& path) = 0;
+    // Stops writing to the board file and starts a new game in memory.
+    virtual void CloseBoardFile() = 0;
+
+    virtual void SaveSnapshot(std::vector<uint8_t>& snapshot) = 0;
+    // Reads the snapshot in place, data can point into a mapped file.
+    virtual void LoadSnapshot(uint8_t const* data, size_t size) = 0;
+    // Saves a snapshot to path on a background thread after every input.
+    // An empty path turns autosave off.
+    virtual void SetAutosavePath(std::wstring const& path) = 0;
+
+    // Serializes the inputs of the current game so that it can be replayed
+    // and verified without a UI, see GameLog.h. Throws if the game was picked
+    // back up from a save, since its log wouldn't start at the beginning.
+    virtual void SaveGameLog(std::vector<uint8_t>& log) = 0;
+
+    virtual int UnrevealedTiles() = 0;
+    virtual int FlagsPlaced() = 0;
+    virtual int SafeTilesRemaining() = 0;
+    // Mines left to flag, can go negative if the player over-flags.
+    virtual int MinesRemaining() = 0;
 };
 
 std::shared_ptr<IMinesweeper> CreateMinesweeper(
     winrt::Windows::UI::Composition::ContainerVisual parentVisual,
     winrt::Windows::Foundation::Numerics::float2 parentSize);
+#endif
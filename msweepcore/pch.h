@@ -1,11 +1,19 @@
 #pragma once
 
+// Everything but the UI, the mapped board files and the game host builds
+// without Windows too, see CMakeLists.txt.
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <windows.h>
+
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Foundation.Collections.h>
 #include <winrt/Windows.Foundation.Numerics.h>
 #include <winrt/Windows.Graphics.h>
 #include <winrt/Windows.UI.Core.h>
 #include <winrt/Windows.UI.Composition.h>
+#endif
 
 #include <vector>
 #include <random>
@@ -13,10 +21,45 @@
 #include <memory>
 #include <chrono>
 #include <map>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <array>
+#include <unordered_map>
+#include <string>
+#include <cstring>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <limits>
+#include <bitset>
+#include <functional>
+#include <deque>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <immintrin.h>
+#define MSWEEP_AVX2_AVAILABLE 1
+#define MSWEEP_AVX2_TARGET
+#elif defined(__x86_64__) || defined(__i386__)
+// GCC and Clang only allow the intrinsics in functions built for AVX2, the
+// rest of the code stays runnable on any x86 CPU.
+#include <immintrin.h>
+#define MSWEEP_AVX2_AVAILABLE 1
+#define MSWEEP_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define MSWEEP_AVX2_AVAILABLE 0
+#endif
 
 // Minesweeper
 #include "msweepcore.h"
 
 #include "IndexHelper.h"
+#include "PaddedLayout.h"
 
 #define SHOW_MINES 0
\ No newline at end of file